@@ -34,8 +34,7 @@ saveas(figure(1),'himmelblauGridSearch','png');
 %%
 % Plot data for 6 generations
 figure(2)
-population = cell(1,1);
-fitness = cell(1,1);
+[ ~, population, fitness ] = readPopulationSnapshots(strcat(saveFolder,'populationSnapshots_himmelblau.bin'));
 for k=1:6
     
     % Specify current generation
@@ -52,12 +51,7 @@ for k=1:6
     elseif( k == 6 )
         indexToUse = 100;
     end
-    
-    % Load data for current generation, for each of the three optimizers
-    for j=indexToUse
-        population{j} = load(strcat(saveFolder,'population_himmelblau_',num2str(j),'.dat'));
-        fitness{j} = load(strcat(saveFolder,'fitness_himmelblau_',num2str(j),'.dat'));
-    end
+    j=indexToUse;
     
     % Plot population for current generation/optimizer on top of porkchop
     subplot(2,3,k)
@@ -23,14 +23,17 @@ plotInterval = 2;
 fitness = cell(numberOfOptimizers,numberOfGenerations);
 population = cell(numberOfOptimizers,numberOfGenerations);
 
+% Load data for all generations (snapshot k+1 contains generation k)
+[ ~, populationSnapshots, fitnessSnapshots ] = readPopulationSnapshots(strcat(saveFolder,'populationSnapshots_mo_mga_EVEEJ.bin'));
+
 % Iterate over requested generations, and plot results
 counter = 1;
 i = 1;
 for j = 1:plotInterval:numberOfGenerations
     
     % Load data for current generation
-    fitness{i,j} =  load(strcat(saveFolder,'fitness_mo_mga_EVEEJ_',num2str(j),'.dat'));
-    population{i,j} =  load(strcat(saveFolder,'population_mo_mga_EVEEJ_',num2str(j),'.dat'));
+    fitness{i,j} =  fitnessSnapshots{j+1};
+    population{i,j} =  populationSnapshots{j+1};
     
     % Plot data, colored by departure date
     figure(1)
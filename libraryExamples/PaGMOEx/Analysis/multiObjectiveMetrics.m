@@ -0,0 +1,61 @@
+%
+% This script plots the convergence metrics of the multi-objective
+% optimizations run by the zdtMultiObjectiveOptimizerComparison.cpp
+% Tudat/Pagmo2 example, as written by the MultiObjectiveMetricsLogger class
+% (Problems/multiObjectiveMetrics.h). Each row of a metrics file contains:
+% generation, number of non-dominated individuals, archive size,
+% hypervolume, inverted generational distance (IGD).
+%
+
+set(0, 'defaultLegendInterpreter','latex');
+set(0, 'defaultAxesTickLabelInterpreter','latex');
+set(0, 'defaultTextInterpreter','latex');
+
+clc
+close all
+clear all
+
+saveFolder = '../SimulationOutput/';
+
+% Define plot settings
+numberOfOptimizers = 3;
+optimizerNames = {'NSGA-II','MOEA/D','IHS'};
+
+% Load and plot data for each optimizer
+for i=1:numberOfOptimizers
+    metrics = load(strcat(saveFolder,'metrics_mo_',num2str(i-1),'.dat'));
+    
+    figure(1)
+    subplot(1,3,1)
+    plot(metrics(:,1),metrics(:,4))
+    hold on
+    
+    subplot(1,3,2)
+    semilogy(metrics(:,1),metrics(:,5))
+    hold on
+    
+    subplot(1,3,3)
+    plot(metrics(:,1),metrics(:,2))
+    hold on
+end
+
+subplot(1,3,1)
+xlabel('Generation [-]')
+ylabel('Hypervolume [-]')
+grid on
+
+subplot(1,3,2)
+xlabel('Generation [-]')
+ylabel('IGD [-]')
+grid on
+
+subplot(1,3,3)
+xlabel('Generation [-]')
+ylabel('Non-dominated individuals [-]')
+legend(optimizerNames,'Location','SouthEast')
+grid on
+
+set(figure(1), 'Units', 'normalized', 'Position', [0,0,0.75 0.4]);
+set(figure(1),'PaperUnits','centimeters','PaperPosition',[0 0 45 15]);
+set(figure(1),'PaperPositionMode','auto');
+saveas(figure(1),'zdtConvergenceMetrics','png');
@@ -33,19 +33,47 @@ set(gcf,'PaperPositionMode','auto');
 pause(0.1)
 saveas(figure(1),'porkchopPlotEarthMars','png');
 
+% Load adaptive grid search data (evaluated points: x, y, Delta V)
+porkchopEarthMarsAdaptive_points = load(strcat(saveFolder,'porkchopEarthMarsAdaptive_points.dat'));
+
+% Plot evaluated points of adaptive grid search, colored by Delta V
+figure(2)
+scatter((porkchopEarthMarsAdaptive_points(:,1)-2451545)/365,porkchopEarthMarsAdaptive_points(:,2),...
+    2,min(porkchopEarthMarsAdaptive_points(:,3),2E4),'filled')
+xlabel('Departure date [years since J2000]')
+ylabel('Travel time [days]')
+title('Adaptive porkchop plot, two-shot impulsive Earth-Mars transfer [m/s]')
+
+colorbar
+
+set(gcf, 'Units', 'normalized', 'Position', [0,0,0.75 0.75]);
+set(gcf,'PaperUnits','centimeters','PaperPosition',[0 0 45 30]);
+set(gcf,'PaperPositionMode','auto');
+
+pause(0.1)
+saveas(figure(2),'adaptivePorkchopPlotEarthMars','png');
+
 % Create list of optimizer names
 optimizers = cell(3,1);
 optimizers{1} = 'NSGA2';
 optimizers{2} = 'MOEAD';
 optimizers{3} = 'IHS';
 
+% Load data for all generations, for each of the three optimizers (snapshot j contains generation j-1)
+populationSnapshots = cell(3,1);
+fitnessSnapshots = cell(3,1);
+for i=1:3
+    [ ~, populationSnapshots{i}, fitnessSnapshots{i} ] = ...
+        readPopulationSnapshots(strcat(saveFolder,'populationSnapshots_mo_EarthMars_',num2str(i-1),'.bin'));
+end
+
 % Plot data for 6 generations
 for k=1:6
     
     % Specify current generation
     population = cell(11,16);
     fitness = cell(11,16);
-    figure(k+1)
+    figure(k+2)
     if( k == 1 )
         indexToUse = 1;
     elseif( k == 2 )
@@ -63,8 +91,8 @@ for k=1:6
     % Load data for current generation, for each of the three optimizers
     for i=1:3
         for j=indexToUse
-            population{i,j} = load(strcat(saveFolder,'population_mo_EarthMars_',num2str(j-1),'_',num2str(i-1),'.dat'));
-            fitness{i,j} = load(strcat(saveFolder,'fitness_mo_EarthMars_',num2str(j-1),'_',num2str(i-1),'.dat'));
+            population{i,j} = populationSnapshots{i}{j};
+            fitness{i,j} = fitnessSnapshots{i}{j};
         end
         
         % Plot population for current generation/optimizer on top of porkchop
@@ -37,6 +37,9 @@ figure(2)
 population = cell(8,1);
 fitness = cell(8,1);
 
+% Load population/fitness for all generations (snapshot j contains generation j-1)
+[ ~, populationSnapshots, fitnessSnapshots ] = readPopulationSnapshots(strcat(dataFolder,'populationSnapshots_targetingPropagation.bin'));
+
 % Plot population cloud over contour plot for 8 generations (unperturbed case)
 for k=1:8
     
@@ -59,10 +62,11 @@ for k=1:8
         indexToUse = 25;
     end
     
-    % Retrieve population/fitness for requested genertion
+    % Retrieve population/fitness for requested genertion (last one if stage converged earlier)
+    indexToUse = min(indexToUse,numel(populationSnapshots));
     j=indexToUse;
-    population{j} = load(strcat(dataFolder,'population_targetingPropagation_',num2str(j-1),'_',num2str(j-1),'.dat'));
-    fitness{j} = load(strcat(dataFolder,'fitness_targetingPropagation_',num2str(j-1),'_',num2str(j-1),'.dat'));
+    population{j} = populationSnapshots{j};
+    fitness{j} = fitnessSnapshots{j};
     
     % Plot current generation on contour plot
     subplot(2,4,k)
@@ -71,7 +75,7 @@ for k=1:8
     scatter(population{indexToUse}(:,1),population{indexToUse}(:,2),25,fitness{indexToUse}(:,1),'*')
     xlabel('Argument of periapsis [deg]')
     ylabel('Longitude of asc. node [deg]')
-    title(strcat('Gen.=',{' '},num2str(indexToUse),{' '},', Min.=',num2str(min(fitness{indexToUse}(:,1))/1000,3),' km'));
+    title(strcat('Gen.=',{' '},num2str(indexToUse-1),{' '},', Min.=',num2str(min(fitness{indexToUse}(:,1))/1000,3),' km'));
 end
 
 set(gcf, 'Units', 'normalized', 'Position', [0,0,0.75 0.75]);
@@ -109,6 +113,9 @@ figure(4)
 population_pert = cell(8,1);
 fitness_pert = cell(8,1);
 
+% Load population/fitness for all generations (snapshot j+1 contains generation j, snapshot 1 the initial population)
+[ ~, populationSnapshots_pert, fitnessSnapshots_pert ] = readPopulationSnapshots(strcat(dataFolder,'populationSnapshots_targetingPropagation_pert.bin'));
+
 % Plot population cloud over contour plot for 4 generations (perturbed case)
 for k=1:4
     
@@ -122,10 +129,11 @@ for k=1:4
         indexToUse = 4;
     end
     
-    %Retrieve population/fitness for requested genertion
+    %Retrieve population/fitness for requested genertion (last one if stage converged earlier)
+    indexToUse = min(indexToUse,numel(populationSnapshots_pert)-1);
     j=indexToUse;
-    population_pert{j} = load(strcat(dataFolder,'population_targetingPropagation_pert_',num2str(j-1),'_',num2str(j-1),'.dat'));
-    fitness_pert{j} = load(strcat(dataFolder,'fitness_targetingPropagation_pert_',num2str(j-1),'_',num2str(j-1),'.dat'));
+    population_pert{j} = populationSnapshots_pert{j+1};
+    fitness_pert{j} = fitnessSnapshots_pert{j+1};
     
     % Plot current generation on contour plot
     subplot(1,4,k)
@@ -0,0 +1,56 @@
+%
+% This function reads a binary population snapshot file, as written by the
+% PopulationSnapshotWriter class (Problems/populationSnapshot.h) of the
+% Tudat/Pagmo2 examples.
+%
+% Output:
+%   generations: generation number of each snapshot (column vector)
+%   population: cell array, with entry k the decision vectors of snapshot k
+%               (one row per individual)
+%   fitness: cell array, with entry k the fitness vectors of snapshot k
+%            (one row per individual)
+%
+function [ generations, population, fitness ] = readPopulationSnapshots( fileName )
+
+fileId = fopen( fileName, 'r', 'ieee-le' );
+if( fileId < 0 )
+    error( strcat('Could not open population snapshot file',{' '},fileName) )
+end
+
+% Read and check header
+fileIdentifier = fread( fileId, 8, '*char' )';
+if( ~strcmp( fileIdentifier, 'TUDATPOP' ) )
+    fclose( fileId );
+    error( strcat(fileName,{' '},'is not a population snapshot file') )
+end
+fileVersion = fread( fileId, 1, 'uint32' );
+if( fileVersion ~= 1 )
+    fclose( fileId );
+    error( strcat('Unsupported population snapshot file version',{' '},num2str(fileVersion)) )
+end
+headerSize = fread( fileId, 1, 'uint32' );
+numberOfIndividuals = fread( fileId, 1, 'uint64' );
+decisionVectorSize = fread( fileId, 1, 'uint64' );
+fitnessVectorSize = fread( fileId, 1, 'uint64' );
+
+% Determine number of (complete) records
+recordSize = 8 + numberOfIndividuals * ( decisionVectorSize + fitnessVectorSize ) * 8;
+fseek( fileId, 0, 'eof' );
+numberOfSnapshots = floor( ( ftell( fileId ) - headerSize ) / recordSize );
+
+% Read records
+generations = zeros( numberOfSnapshots, 1 );
+population = cell( numberOfSnapshots, 1 );
+fitness = cell( numberOfSnapshots, 1 );
+fseek( fileId, headerSize, 'bof' );
+for k = 1:numberOfSnapshots
+    generations( k ) = fread( fileId, 1, 'uint64' );
+    population{ k } = reshape( fread( fileId, numberOfIndividuals * decisionVectorSize, 'double' ), ...
+        decisionVectorSize, numberOfIndividuals )';
+    fitness{ k } = reshape( fread( fileId, numberOfIndividuals * fitnessVectorSize, 'double' ), ...
+        fitnessVectorSize, numberOfIndividuals )';
+end
+
+fclose( fileId );
+
+end
@@ -0,0 +1,250 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_ADAPTIVE_GRID_SEARCH_H
+#define TUDAT_PAGMO_ADAPTIVE_GRID_SEARCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "gridSearch.h"
+
+namespace tudat_pagmo_applications
+{
+
+//! Settings for a two-dimensional adaptive grid search
+struct AdaptiveGridSearchSettings
+{
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param numberOfInitialCells Number of cells of initial (coarse) grid, per dimension
+     *  \param maximumRefinementLevel Maximum number of times that an initial cell is subdivided
+     *  \param fitnessThreshold A cell is refined if the fitness in (at least) one of its corners is below this value
+     *  \param fitnessVariationThreshold A cell is refined if the difference between maximum and minimum fitness in its corners
+     *  exceeds this value (i.e. if the fitness gradient over the cell is steep)
+     */
+    AdaptiveGridSearchSettings( const std::vector< int >& numberOfInitialCells,
+                                const unsigned int maximumRefinementLevel,
+                                const double fitnessThreshold,
+                                const double fitnessVariationThreshold = std::numeric_limits< double >::infinity( ) ):
+        numberOfInitialCells_( numberOfInitialCells ), maximumRefinementLevel_( maximumRefinementLevel ),
+        fitnessThreshold_( fitnessThreshold ), fitnessVariationThreshold_( fitnessVariationThreshold ){ }
+
+    std::vector< int > numberOfInitialCells_;
+    unsigned int maximumRefinementLevel_;
+    double fitnessThreshold_;
+    double fitnessVariationThreshold_;
+};
+
+//! Leaf cell of the quadtree produced by an adaptive grid search
+struct AdaptiveGridCell
+{
+    //! Lower and upper bounds of the cell (lower bounds as first entry, upper bounds as second)
+    double lowerBounds_[ 2 ];
+    double upperBounds_[ 2 ];
+
+    //! Number of times that the initial cell has been subdivided to obtain this cell
+    unsigned int refinementLevel_;
+
+    //! Fitness at the cell corners, in order (lower, lower), (upper, lower), (lower, upper), (upper, upper)
+    double cornerFitness_[ 4 ];
+};
+
+//! Results of a two-dimensional adaptive grid search
+struct AdaptiveGridSearchResult
+{
+    //! Leaf cells of the quadtree
+    std::vector< AdaptiveGridCell > cells_;
+
+    //! All evaluated points, stored as decision vector (first two entries) and fitness (third entry)
+    std::vector< std::vector< double > > evaluatedPoints_;
+};
+
+//! Function to evaluate the first objective of a two-dimensional problem using an adaptively refined grid.
+/*!
+ *  Function to evaluate the first objective of a two-dimensional problem using an adaptively refined grid. The search starts
+ *  from a coarse uniform grid of cells. Cells for which the fitness is below a threshold in one of the corners, or for which
+ *  the fitness variation over the corners is large, are split into four equal cells, up to a maximum refinement level. The
+ *  result is a sparse quadtree, for which only the leaf cells are returned. The corners of all cells are on the uniform grid
+ *  of the finest level, on which each point is evaluated only once. All new points of a refinement level are evaluated in
+ *  parallel, in the same manner as in performGridSearch.
+ *  \param problem Problem for which the grid search is performed
+ *  \param bounds Bounds of grid (lower bounds as first entry, upper bounds as second)
+ *  \param settings Settings for initial grid and refinement criteria
+ *  \param progressFunction Function called after each refinement level, with the number of points evaluated so far and the
+ *  number of points that would be required by a uniform grid at the finest refinement level (none if empty)
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ *  \return Leaf cells of the quadtree and list of evaluated points
+ */
+inline AdaptiveGridSearchResult performAdaptiveGridSearch(
+        const pagmo::problem& problem,
+        const std::vector< std::vector< double > >& bounds,
+        const AdaptiveGridSearchSettings& settings,
+        const GridSearchProgressFunction progressFunction = GridSearchProgressFunction( ),
+        const unsigned int numberOfThreads = 0 )
+{
+    if( problem.get_nx( ) != 2 || bounds.size( ) != 2 || bounds.at( 0 ).size( ) != 2 || bounds.at( 1 ).size( ) != 2 ||
+            settings.numberOfInitialCells_.size( ) != 2 )
+    {
+        throw std::runtime_error( "Error in adaptive grid search, only two-dimensional grids are supported." );
+    }
+    if( settings.numberOfInitialCells_.at( 0 ) < 1 || settings.numberOfInitialCells_.at( 1 ) < 1 )
+    {
+        throw std::runtime_error( "Error in adaptive grid search, at least one initial cell is required per dimension." );
+    }
+
+    // Define uniform grid at finest refinement level, on which all cell corners are located
+    const std::int64_t finestLevelScaling = static_cast< std::int64_t >( 1 ) << settings.maximumRefinementLevel_;
+    const std::int64_t numberOfFinestPoints[ 2 ] =
+    { settings.numberOfInitialCells_.at( 0 ) * finestLevelScaling + 1,
+      settings.numberOfInitialCells_.at( 1 ) * finestLevelScaling + 1 };
+    double finestSpacing[ 2 ];
+    for( unsigned int i = 0; i < 2; i++ )
+    {
+        finestSpacing[ i ] = ( bounds[ 1 ][ i ] - bounds[ 0 ][ i ] ) / static_cast< double >( numberOfFinestPoints[ i ] - 1 );
+    }
+
+    unsigned int numberOfThreadsToUse = numberOfThreads;
+    const std::vector< pagmo::problem > problemCopies = createThreadProblemCopies( problem, numberOfThreadsToUse );
+
+    // Fitness of all points evaluated so far, indexed by flattened index on finest grid
+    std::unordered_map< std::int64_t, double > evaluatedFitness;
+    auto getFinestGridIndex = [ & ]( const std::int64_t i, const std::int64_t j )
+    {
+        return i * numberOfFinestPoints[ 1 ] + j;
+    };
+
+    // Cells are stored as lower-corner index on finest grid, and refinement level
+    struct CellIndex
+    {
+        std::int64_t lowerIndices_[ 2 ];
+        unsigned int refinementLevel_;
+    };
+
+    std::vector< CellIndex > cellsToEvaluate;
+    for( int i = 0; i < settings.numberOfInitialCells_.at( 0 ); i++ )
+    {
+        for( int j = 0; j < settings.numberOfInitialCells_.at( 1 ); j++ )
+        {
+            cellsToEvaluate.push_back( CellIndex{ { i * finestLevelScaling, j * finestLevelScaling }, 0 } );
+        }
+    }
+
+    AdaptiveGridSearchResult adaptiveGridSearchResult;
+    while( !cellsToEvaluate.empty( ) )
+    {
+        // Collect corners of current cells that have not yet been evaluated
+        std::vector< std::int64_t > newPoints;
+        for( unsigned int k = 0; k < cellsToEvaluate.size( ); k++ )
+        {
+            const std::int64_t cellSize = finestLevelScaling >> cellsToEvaluate.at( k ).refinementLevel_;
+            for( unsigned int corner = 0; corner < 4; corner++ )
+            {
+                const std::int64_t pointIndex = getFinestGridIndex(
+                            cellsToEvaluate.at( k ).lowerIndices_[ 0 ] + ( corner % 2 ) * cellSize,
+                            cellsToEvaluate.at( k ).lowerIndices_[ 1 ] + ( corner / 2 ) * cellSize );
+                if( evaluatedFitness.count( pointIndex ) == 0 )
+                {
+                    evaluatedFitness[ pointIndex ] = std::numeric_limits< double >::quiet_NaN( );
+                    newPoints.push_back( pointIndex );
+                }
+            }
+        }
+
+        // Evaluate new points in parallel
+        std::vector< double > newFitness( newPoints.size( ) );
+        executeTasksInParallel(
+                    newPoints.size( ), [ & ]( const std::size_t pointIndex, const unsigned int threadIndex )
+        {
+            const pagmo::problem& problemToEvaluate =
+                    problemCopies.empty( ) ? problem : problemCopies.at( threadIndex );
+            const pagmo::vector_double decisionVector =
+            { bounds[ 0 ][ 0 ] + static_cast< double >( newPoints.at( pointIndex ) / numberOfFinestPoints[ 1 ] ) * finestSpacing[ 0 ],
+              bounds[ 0 ][ 1 ] + static_cast< double >( newPoints.at( pointIndex ) % numberOfFinestPoints[ 1 ] ) * finestSpacing[ 1 ] };
+            newFitness[ pointIndex ] = problemToEvaluate.fitness( decisionVector ).at( 0 );
+        }, numberOfThreadsToUse );
+
+        for( unsigned int k = 0; k < newPoints.size( ); k++ )
+        {
+            evaluatedFitness[ newPoints.at( k ) ] = newFitness.at( k );
+            adaptiveGridSearchResult.evaluatedPoints_.push_back(
+            { bounds[ 0 ][ 0 ] + static_cast< double >( newPoints.at( k ) / numberOfFinestPoints[ 1 ] ) * finestSpacing[ 0 ],
+              bounds[ 0 ][ 1 ] + static_cast< double >( newPoints.at( k ) % numberOfFinestPoints[ 1 ] ) * finestSpacing[ 1 ],
+              newFitness.at( k ) } );
+        }
+
+        if( progressFunction )
+        {
+            progressFunction( evaluatedFitness.size( ),
+                              static_cast< std::size_t >( numberOfFinestPoints[ 0 ] * numberOfFinestPoints[ 1 ] ) );
+        }
+
+        // Split cells that meet refinement criteria, and store the others as leaf cells
+        std::vector< CellIndex > refinedCells;
+        for( unsigned int k = 0; k < cellsToEvaluate.size( ); k++ )
+        {
+            const CellIndex& currentCell = cellsToEvaluate.at( k );
+            const std::int64_t cellSize = finestLevelScaling >> currentCell.refinementLevel_;
+
+            AdaptiveGridCell leafCell;
+            double minimumFitness = std::numeric_limits< double >::infinity( );
+            double maximumFitness = -std::numeric_limits< double >::infinity( );
+            for( unsigned int corner = 0; corner < 4; corner++ )
+            {
+                leafCell.cornerFitness_[ corner ] = evaluatedFitness.at(
+                            getFinestGridIndex( currentCell.lowerIndices_[ 0 ] + ( corner % 2 ) * cellSize,
+                                                currentCell.lowerIndices_[ 1 ] + ( corner / 2 ) * cellSize ) );
+                if( std::isfinite( leafCell.cornerFitness_[ corner ] ) )
+                {
+                    minimumFitness = std::min( minimumFitness, leafCell.cornerFitness_[ corner ] );
+                    maximumFitness = std::max( maximumFitness, leafCell.cornerFitness_[ corner ] );
+                }
+            }
+
+            const bool refineCell = ( currentCell.refinementLevel_ < settings.maximumRefinementLevel_ ) &&
+                    ( minimumFitness < settings.fitnessThreshold_ ||
+                      ( maximumFitness - minimumFitness ) > settings.fitnessVariationThreshold_ );
+            if( refineCell )
+            {
+                const std::int64_t childSize = cellSize / 2;
+                for( unsigned int child = 0; child < 4; child++ )
+                {
+                    refinedCells.push_back( CellIndex{ { currentCell.lowerIndices_[ 0 ] + ( child % 2 ) * childSize,
+                                                         currentCell.lowerIndices_[ 1 ] + ( child / 2 ) * childSize },
+                                                       currentCell.refinementLevel_ + 1 } );
+                }
+            }
+            else
+            {
+                for( unsigned int i = 0; i < 2; i++ )
+                {
+                    leafCell.lowerBounds_[ i ] = bounds[ 0 ][ i ] +
+                            static_cast< double >( currentCell.lowerIndices_[ i ] ) * finestSpacing[ i ];
+                    leafCell.upperBounds_[ i ] = bounds[ 0 ][ i ] +
+                            static_cast< double >( currentCell.lowerIndices_[ i ] + cellSize ) * finestSpacing[ i ];
+                }
+                leafCell.refinementLevel_ = currentCell.refinementLevel_;
+                adaptiveGridSearchResult.cells_.push_back( leafCell );
+            }
+        }
+        cellsToEvaluate.swap( refinedCells );
+    }
+
+    return adaptiveGridSearchResult;
+}
+
+}
+
+#endif // TUDAT_PAGMO_ADAPTIVE_GRID_SEARCH_H
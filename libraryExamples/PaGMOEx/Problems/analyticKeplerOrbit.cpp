@@ -0,0 +1,214 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "analyticKeplerOrbit.h"
+
+//! Constructor
+AnalyticKeplerOrbit::AnalyticKeplerOrbit( const Eigen::Matrix< double, 6, 1 >& keplerElements,
+                                          const double gravitationalParameter,
+                                          const double referenceEpoch ):
+    semiMajorAxis_( keplerElements( 0 ) ), eccentricity_( keplerElements( 1 ) ), referenceEpoch_( referenceEpoch )
+{
+    if( !( semiMajorAxis_ > 0.0 ) || !( eccentricity_ >= 0.0 ) || !( eccentricity_ < 1.0 ) )
+    {
+        throw std::runtime_error( "Error when creating analytic Kepler orbit, only elliptical orbits are supported." );
+    }
+
+    meanMotion_ = std::sqrt( gravitationalParameter / ( semiMajorAxis_ * semiMajorAxis_ * semiMajorAxis_ ) );
+
+    const double trueAnomaly = keplerElements( 5 );
+    const double eccentricAnomaly = std::atan2( std::sqrt( 1.0 - eccentricity_ * eccentricity_ ) * std::sin( trueAnomaly ),
+                                                eccentricity_ + std::cos( trueAnomaly ) );
+    meanAnomalyAtReferenceEpoch_ = eccentricAnomaly - eccentricity_ * std::sin( eccentricAnomaly );
+
+    // Orientation of orbital plane, from rotations about z (node), x (inclination) and z (argument of periapsis)
+    const double cosineOfInclination = std::cos( keplerElements( 2 ) );
+    const double sineOfInclination = std::sin( keplerElements( 2 ) );
+    const double cosineOfArgumentOfPeriapsis = std::cos( keplerElements( 3 ) );
+    const double sineOfArgumentOfPeriapsis = std::sin( keplerElements( 3 ) );
+    const double cosineOfNode = std::cos( keplerElements( 4 ) );
+    const double sineOfNode = std::sin( keplerElements( 4 ) );
+
+    periapsisDirection_ <<
+            cosineOfNode * cosineOfArgumentOfPeriapsis - sineOfNode * sineOfArgumentOfPeriapsis * cosineOfInclination,
+            sineOfNode * cosineOfArgumentOfPeriapsis + cosineOfNode * sineOfArgumentOfPeriapsis * cosineOfInclination,
+            sineOfArgumentOfPeriapsis * sineOfInclination;
+    perpendicularDirection_ <<
+            -cosineOfNode * sineOfArgumentOfPeriapsis - sineOfNode * cosineOfArgumentOfPeriapsis * cosineOfInclination,
+            -sineOfNode * sineOfArgumentOfPeriapsis + cosineOfNode * cosineOfArgumentOfPeriapsis * cosineOfInclination,
+            cosineOfArgumentOfPeriapsis * sineOfInclination;
+}
+
+//! Function to compute the Cartesian states at a set of epochs (one column per epoch)
+Eigen::Matrix< double, 6, Eigen::Dynamic > AnalyticKeplerOrbit::computeCartesianStates( const Eigen::VectorXd& epochs ) const
+{
+    const Eigen::ArrayXd meanAnomalies =
+            meanAnomalyAtReferenceEpoch_ + meanMotion_ * ( epochs.array( ) - referenceEpoch_ );
+    const Eigen::ArrayXd eccentricAnomalies = computeEccentricAnomalies( meanAnomalies );
+    const Eigen::ArrayXd cosineOfEccentricAnomalies = eccentricAnomalies.cos( );
+    const Eigen::ArrayXd sineOfEccentricAnomalies = eccentricAnomalies.sin( );
+
+    // Position and velocity in perifocal frame
+    const double eccentricityFactor = std::sqrt( 1.0 - eccentricity_ * eccentricity_ );
+    const Eigen::ArrayXd velocityFactors =
+            meanMotion_ * semiMajorAxis_ / ( 1.0 - eccentricity_ * cosineOfEccentricAnomalies );
+    const Eigen::ArrayXd periapsisPositions = semiMajorAxis_ * ( cosineOfEccentricAnomalies - eccentricity_ );
+    const Eigen::ArrayXd perpendicularPositions = semiMajorAxis_ * eccentricityFactor * sineOfEccentricAnomalies;
+    const Eigen::ArrayXd periapsisVelocities = -velocityFactors * sineOfEccentricAnomalies;
+    const Eigen::ArrayXd perpendicularVelocities = velocityFactors * eccentricityFactor * cosineOfEccentricAnomalies;
+
+    Eigen::Matrix< double, 6, Eigen::Dynamic > cartesianStates( 6, epochs.rows( ) );
+    cartesianStates.topRows< 3 >( ) = periapsisDirection_ * periapsisPositions.matrix( ).transpose( ) +
+            perpendicularDirection_ * perpendicularPositions.matrix( ).transpose( );
+    cartesianStates.bottomRows< 3 >( ) = periapsisDirection_ * periapsisVelocities.matrix( ).transpose( ) +
+            perpendicularDirection_ * perpendicularVelocities.matrix( ).transpose( );
+    return cartesianStates;
+}
+
+//! Function to solve Kepler's equation for the eccentric anomalies at the given mean anomalies (Newton iteration)
+Eigen::ArrayXd AnalyticKeplerOrbit::computeEccentricAnomalies( const Eigen::ArrayXd& meanAnomalies ) const
+{
+    const double twoPi = 2.0 * 3.14159265358979323846;
+    const int maximumNumberOfIterations = 50;
+    const double tolerance = 1.0E-14;
+
+    // Reduce mean anomalies to [-pi,pi]; initial guess of Danby (1987), for which Newton iteration converges for e < 1
+    const Eigen::ArrayXd reducedMeanAnomalies = meanAnomalies - twoPi * ( meanAnomalies / twoPi ).round( );
+    Eigen::ArrayXd eccentricAnomalies =
+            reducedMeanAnomalies + 0.85 * eccentricity_ * reducedMeanAnomalies.sin( ).sign( );
+    for( int i = 0; i < maximumNumberOfIterations; i++ )
+    {
+        const Eigen::ArrayXd corrections =
+                ( eccentricAnomalies - eccentricity_ * eccentricAnomalies.sin( ) - reducedMeanAnomalies ) /
+                ( 1.0 - eccentricity_ * eccentricAnomalies.cos( ) );
+        eccentricAnomalies -= corrections;
+        if( corrections.rows( ) == 0 || corrections.abs( ).maxCoeff( ) < tolerance )
+        {
+            break;
+        }
+    }
+    return eccentricAnomalies;
+}
+
+//! Function to compute the closest approach of a Keplerian orbit to a target that is fixed in a uniformly rotating frame.
+double computeKeplerOrbitClosestApproach(
+        const AnalyticKeplerOrbit& orbit, const Eigen::Vector3d& targetPosition, const double frameRotationRate,
+        const double startEpoch, const double endEpoch, const double gridStepSize, double& closestApproachTime )
+{
+    if( !( endEpoch > startEpoch ) || !( gridStepSize > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when computing Kepler orbit closest approach, invalid time interval." );
+    }
+
+    // Position of target in inertial frame, and separation and its rate of change, at a set of epochs
+    auto computeSeparations = [ & ]( const Eigen::VectorXd& epochs, Eigen::Matrix< double, 3, Eigen::Dynamic >& separations,
+            Eigen::Matrix< double, 3, Eigen::Dynamic >& separationRates )
+    {
+        const Eigen::Matrix< double, 6, Eigen::Dynamic > states = orbit.computeCartesianStates( epochs );
+        const Eigen::ArrayXd cosineOfAngles = ( frameRotationRate * epochs.array( ) ).cos( );
+        const Eigen::ArrayXd sineOfAngles = ( frameRotationRate * epochs.array( ) ).sin( );
+
+        Eigen::Matrix< double, 3, Eigen::Dynamic > targetPositions( 3, epochs.rows( ) );
+        targetPositions.row( 0 ) = ( cosineOfAngles * targetPosition.x( ) - sineOfAngles * targetPosition.y( ) ).matrix( ).transpose( );
+        targetPositions.row( 1 ) = ( sineOfAngles * targetPosition.x( ) + cosineOfAngles * targetPosition.y( ) ).matrix( ).transpose( );
+        targetPositions.row( 2 ).setConstant( targetPosition.z( ) );
+
+        separations = states.topRows< 3 >( ) - targetPositions;
+        separationRates = states.bottomRows< 3 >( );
+        separationRates.row( 0 ) += frameRotationRate * targetPositions.row( 1 );
+        separationRates.row( 1 ) -= frameRotationRate * targetPositions.row( 0 );
+    };
+
+    // Evaluate distance on grid, including end epoch
+    const int numberOfGridPoints = static_cast< int >( std::ceil( ( endEpoch - startEpoch ) / gridStepSize ) ) + 1;
+    Eigen::VectorXd gridEpochs = Eigen::VectorXd::LinSpaced(
+                numberOfGridPoints, startEpoch, startEpoch + ( numberOfGridPoints - 1 ) * gridStepSize );
+    gridEpochs( numberOfGridPoints - 1 ) = endEpoch;
+
+    Eigen::Matrix< double, 3, Eigen::Dynamic > gridSeparations, gridSeparationRates;
+    computeSeparations( gridEpochs, gridSeparations, gridSeparationRates );
+    const Eigen::VectorXd gridDistances = gridSeparations.colwise( ).norm( ).transpose( );
+    const Eigen::VectorXd gridRangeRateFactors =
+            gridSeparations.cwiseProduct( gridSeparationRates ).colwise( ).sum( ).transpose( );
+
+    int closestGridIndex;
+    double closestDistance = gridDistances.minCoeff( &closestGridIndex );
+    closestApproachTime = gridEpochs( closestGridIndex );
+
+    // The range-rate (times the distance) changes sign from negative to positive in the interval before the closest grid
+    // point if it is positive there, and in the interval after it otherwise
+    int lowerIndex = ( gridRangeRateFactors( closestGridIndex ) > 0.0 ) ? closestGridIndex - 1 : closestGridIndex;
+    if( lowerIndex < 0 || lowerIndex + 1 >= numberOfGridPoints ||
+            !( gridRangeRateFactors( lowerIndex ) < 0.0 && gridRangeRateFactors( lowerIndex + 1 ) > 0.0 ) )
+    {
+        // Closest approach at boundary of interval
+        return closestDistance;
+    }
+
+    // Root-finding on range-rate with the Illinois variant of the regula falsi method
+    const int maximumNumberOfIterations = 100;
+    const double timeTolerance = 1.0E-6;
+
+    double lowerEpoch = gridEpochs( lowerIndex );
+    double upperEpoch = gridEpochs( lowerIndex + 1 );
+    double lowerValue = gridRangeRateFactors( lowerIndex );
+    double upperValue = gridRangeRateFactors( lowerIndex + 1 );
+    int lastUpdatedSide = 0;
+
+    Eigen::VectorXd currentEpoch( 1 );
+    Eigen::Matrix< double, 3, Eigen::Dynamic > currentSeparation, currentSeparationRate;
+    for( int i = 0; i < maximumNumberOfIterations && ( upperEpoch - lowerEpoch ) > timeTolerance; i++ )
+    {
+        currentEpoch( 0 ) = ( lowerEpoch * upperValue - upperEpoch * lowerValue ) / ( upperValue - lowerValue );
+        computeSeparations( currentEpoch, currentSeparation, currentSeparationRate );
+        const double currentValue = currentSeparation.col( 0 ).dot( currentSeparationRate.col( 0 ) );
+
+        if( currentValue == 0.0 )
+        {
+            lowerEpoch = upperEpoch = currentEpoch( 0 );
+            break;
+        }
+        else if( currentValue < 0.0 )
+        {
+            lowerEpoch = currentEpoch( 0 );
+            lowerValue = currentValue;
+            if( lastUpdatedSide == -1 )
+            {
+                upperValue *= 0.5;
+            }
+            lastUpdatedSide = -1;
+        }
+        else
+        {
+            upperEpoch = currentEpoch( 0 );
+            upperValue = currentValue;
+            if( lastUpdatedSide == 1 )
+            {
+                lowerValue *= 0.5;
+            }
+            lastUpdatedSide = 1;
+        }
+    }
+
+    currentEpoch( 0 ) = 0.5 * ( lowerEpoch + upperEpoch );
+    computeSeparations( currentEpoch, currentSeparation, currentSeparationRate );
+    const double refinedDistance = currentSeparation.col( 0 ).norm( );
+    if( refinedDistance < closestDistance )
+    {
+        closestDistance = refinedDistance;
+        closestApproachTime = currentEpoch( 0 );
+    }
+
+    return closestDistance;
+}
@@ -0,0 +1,89 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_ANALYTIC_KEPLER_ORBIT_H
+#define TUDAT_EXAMPLE_PAGMO_ANALYTIC_KEPLER_ORBIT_H
+
+#include <Eigen/Core>
+
+//! Unperturbed (Keplerian) elliptical orbit, of which the Cartesian state is evaluated in closed form.
+/*!
+ *  Unperturbed (Keplerian) elliptical orbit, of which the Cartesian state is evaluated in closed form (by solving Kepler's
+ *  equation), so that no numerical propagation is required. The states at a set of epochs are computed in a single
+ *  vectorized evaluation.
+ */
+class AnalyticKeplerOrbit
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param keplerElements Kepler elements at reference epoch, in the order of Tudat (semi-major axis, eccentricity,
+     *  inclination, argument of periapsis, longitude of ascending node, true anomaly). Only elliptical orbits are supported.
+     *  \param gravitationalParameter Gravitational parameter of central body
+     *  \param referenceEpoch Epoch at which the Kepler elements are defined
+     */
+    AnalyticKeplerOrbit( const Eigen::Matrix< double, 6, 1 >& keplerElements,
+                         const double gravitationalParameter,
+                         const double referenceEpoch );
+
+    //! Function to compute the Cartesian states at a set of epochs (one column per epoch)
+    Eigen::Matrix< double, 6, Eigen::Dynamic > computeCartesianStates( const Eigen::VectorXd& epochs ) const;
+
+    //! Function to compute the Cartesian state at a single epoch
+    Eigen::Matrix< double, 6, 1 > computeCartesianState( const double epoch ) const
+    {
+        return computeCartesianStates( Eigen::VectorXd::Constant( 1, epoch ) );
+    }
+
+private:
+
+    //! Function to solve Kepler's equation for the eccentric anomalies at the given mean anomalies (Newton iteration)
+    Eigen::ArrayXd computeEccentricAnomalies( const Eigen::ArrayXd& meanAnomalies ) const;
+
+    double semiMajorAxis_;
+
+    double eccentricity_;
+
+    double meanMotion_;
+
+    double meanAnomalyAtReferenceEpoch_;
+
+    double referenceEpoch_;
+
+    //! Unit vector from central body to periapsis
+    Eigen::Vector3d periapsisDirection_;
+
+    //! Unit vector in orbital plane, perpendicular to periapsisDirection_ in the direction of motion
+    Eigen::Vector3d perpendicularDirection_;
+};
+
+//! Function to compute the closest approach of a Keplerian orbit to a target that is fixed in a uniformly rotating frame.
+/*!
+ *  Function to compute the closest approach of a Keplerian orbit to a target that is fixed in a frame rotating uniformly
+ *  about the z-axis of the inertial frame (see ClosestApproachMonitor for the conventions). The distance is evaluated on a
+ *  grid of epochs (in a single vectorized evaluation of the orbit), after which the epoch of closest approach is found by
+ *  root-finding on the range-rate in the intervals adjacent to the closest grid point. The closest approach is therefore
+ *  exact (up to the tolerance of the root finder), provided that the grid resolves the distance minima.
+ *  \param orbit Orbit of the body
+ *  \param targetPosition Position of target in rotating frame (coinciding with inertial frame at t=0)
+ *  \param frameRotationRate Rotation rate of rotating frame about z-axis
+ *  \param startEpoch Start of interval in which the closest approach is computed
+ *  \param endEpoch End of interval in which the closest approach is computed
+ *  \param gridStepSize Step size of grid on which the distance is evaluated
+ *  \param closestApproachTime Epoch of closest approach (returned by reference)
+ *  \return Distance to target at closest approach
+ */
+double computeKeplerOrbitClosestApproach(
+        const AnalyticKeplerOrbit& orbit, const Eigen::Vector3d& targetPosition, const double frameRotationRate,
+        const double startEpoch, const double endEpoch, const double gridStepSize, double& closestApproachTime );
+
+#endif // TUDAT_EXAMPLE_PAGMO_ANALYTIC_KEPLER_ORBIT_H
@@ -6,6 +6,9 @@
 #include "Tudat/InputOutput/basicInputOutput.h"
 #include "Tudat/Basics/utilities.h"
 
+#include "gridSearch.h"
+#include "adaptiveGridSearch.h"
+
 namespace tudat_pagmo_applications
 {
 
@@ -34,54 +37,102 @@ static inline std::string getOutputPath(
     return outputPath;
 }
 
+//! Function to perform a grid search over a problem, and write the results to files.
+/*!
+ *  Function to perform a grid search over a problem, and write the results to files. The grid is evaluated in parallel
+ *  (see performGridSearch). For a two-dimensional grid, the fitness values are written as a matrix, for higher dimensions
+ *  the rows correspond to the first dimension and the columns to the (flattened) remaining dimensions.
+ *  \param problem Problem for which the grid search is performed
+ *  \param bounds Bounds of grid (lower bounds as first entry, upper bounds as second)
+ *  \param numberOfPoints Number of grid points per dimension
+ *  \param fileName Base name of output files
+ *  \param progressFunction Function that is called after each evaluated tile of the grid (none if empty)
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ */
 void createGridSearch(
-        pagmo::problem& problem,
+        const pagmo::problem& problem,
         const std::vector< std::vector< double > >& bounds,
         const std::vector< int > numberOfPoints,
-        const std::string& fileName )
+        const std::string& fileName,
+        const GridSearchProgressFunction progressFunction = GridSearchProgressFunction( ),
+        const unsigned int numberOfThreads = 0 )
 {
-    if( bounds.at( 0 ).size( ) != 2 )
-    {
-        std::cerr<<"Warning when plotting grid search, size of problem does not equal 2"<<std::endl;
-    }
-    Eigen::MatrixXd gridSearch = Eigen::MatrixXd( numberOfPoints.at( 0 ), numberOfPoints.at( 1 ) );
+    GridSearchResult gridSearchResult = performGridSearch(
+                problem, bounds, numberOfPoints, progressFunction, numberOfThreads );
 
-    double xSpacing = ( bounds[ 1 ][ 0 ] - bounds[ 0 ][ 0 ] ) / static_cast< double >( numberOfPoints.at( 0 ) - 1 );
-    double ySpacing = ( bounds[ 1 ][ 1 ] - bounds[ 0 ][ 1 ] ) / static_cast< double >( numberOfPoints.at( 1 ) - 1 );
+    const long numberOfRows = numberOfPoints.at( 0 );
+    const long numberOfColumns = static_cast< long >( gridSearchResult.fitnessValues_.size( ) ) / numberOfRows;
+    Eigen::MatrixXd gridSearch = Eigen::Map< const Eigen::Matrix< double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor > >(
+                gridSearchResult.fitnessValues_.data( ), numberOfRows, numberOfColumns );
 
-    std::vector< double > decisionVector;
-    decisionVector.resize( 2 );
-
-    std::vector< double > xDataPoints;
-    for( int i = 0; i < numberOfPoints.at( 0 ); i++ )
+    tudat::input_output::writeMatrixToFile( gridSearch, fileName + ".dat" , 16, getOutputPath( ) );
+    for( unsigned int i = 0; i < gridSearchResult.dataPoints_.size( ); i++ )
     {
-        xDataPoints.push_back( bounds[ 0 ][ 0 ] + static_cast< double >( i ) * xSpacing );
+        std::string dimensionName;
+        if( i == 0 )
+        {
+            dimensionName = "x";
+        }
+        else if( i == 1 )
+        {
+            dimensionName = "y";
+        }
+        else
+        {
+            dimensionName = "x" + std::to_string( i );
+        }
+        tudat::input_output::writeMatrixToFile( tudat::utilities::convertStlVectorToEigenVector(
+                                                    gridSearchResult.dataPoints_.at( i ) ),
+                                                fileName + "_" + dimensionName + "_data.dat", 16, getOutputPath( ) );
     }
+}
 
-    std::vector< double > yDataPoints;
-    for( int j = 0; j < numberOfPoints.at( 1 ); j++ )
+//! Function to perform an adaptive grid search over a two-dimensional problem, and write the results to files.
+/*!
+ *  Function to perform an adaptive grid search over a two-dimensional problem (see performAdaptiveGridSearch), and write the
+ *  results to files. The leaf cells of the quadtree are written to the file fileName.dat, with one row per cell, containing
+ *  lower and upper x-bounds, lower and upper y-bounds, refinement level and the fitness in the four cell corners. All evaluated
+ *  points are written to the file fileName_points.dat, with x, y and fitness on each row.
+ *  \param problem Problem for which the grid search is performed
+ *  \param bounds Bounds of grid (lower bounds as first entry, upper bounds as second)
+ *  \param settings Settings for initial grid and refinement criteria
+ *  \param fileName Base name of output files
+ *  \param progressFunction Function that is called after each refinement level (none if empty)
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ */
+inline void createAdaptiveGridSearch(
+        const pagmo::problem& problem,
+        const std::vector< std::vector< double > >& bounds,
+        const AdaptiveGridSearchSettings& settings,
+        const std::string& fileName,
+        const GridSearchProgressFunction progressFunction = GridSearchProgressFunction( ),
+        const unsigned int numberOfThreads = 0 )
+{
+    AdaptiveGridSearchResult adaptiveGridSearchResult = performAdaptiveGridSearch(
+                problem, bounds, settings, progressFunction, numberOfThreads );
+
+    Eigen::MatrixXd cellData( adaptiveGridSearchResult.cells_.size( ), 9 );
+    for( unsigned int i = 0; i < adaptiveGridSearchResult.cells_.size( ); i++ )
     {
-        yDataPoints.push_back( bounds[ 0 ][ 1 ] + static_cast< double >( j ) * ySpacing );
+        const AdaptiveGridCell& currentCell = adaptiveGridSearchResult.cells_.at( i );
+        cellData.row( i ) << currentCell.lowerBounds_[ 0 ], currentCell.upperBounds_[ 0 ],
+                currentCell.lowerBounds_[ 1 ], currentCell.upperBounds_[ 1 ],
+                static_cast< double >( currentCell.refinementLevel_ ),
+                currentCell.cornerFitness_[ 0 ], currentCell.cornerFitness_[ 1 ],
+                currentCell.cornerFitness_[ 2 ], currentCell.cornerFitness_[ 3 ];
     }
 
-    for( int i = 0; i < numberOfPoints.at( 0 ); i++ )
+    Eigen::MatrixXd pointData( adaptiveGridSearchResult.evaluatedPoints_.size( ), 3 );
+    for( unsigned int i = 0; i < adaptiveGridSearchResult.evaluatedPoints_.size( ); i++ )
     {
-        std::cout<<"Grid search "<<i<<std::endl;
-        for( int j = 0; j < numberOfPoints.at( 1 ); j++ )
+        for( unsigned int j = 0; j < 3; j++ )
         {
-            decisionVector[ 0 ] = xDataPoints[ i ];
-            decisionVector[ 1 ] = yDataPoints[ j ];
-
-            gridSearch( i, j ) = problem.fitness( decisionVector ).at( 0 );
+            pointData( i, j ) = adaptiveGridSearchResult.evaluatedPoints_.at( i ).at( j );
         }
     }
 
-    tudat::input_output::writeMatrixToFile( gridSearch, fileName + ".dat" , 16, getOutputPath( ) );
-    tudat::input_output::writeMatrixToFile( tudat::utilities::convertStlVectorToEigenVector(
-                                                xDataPoints ), fileName + "_x_data.dat", 16, getOutputPath( ) );
-    tudat::input_output::writeMatrixToFile( tudat::utilities::convertStlVectorToEigenVector(
-                                                yDataPoints ), fileName + "_y_data.dat", 16, getOutputPath( ) );
-
+    tudat::input_output::writeMatrixToFile( cellData, fileName + ".dat" , 16, getOutputPath( ) );
+    tudat::input_output::writeMatrixToFile( pointData, fileName + "_points.dat" , 16, getOutputPath( ) );
 }
 
 }
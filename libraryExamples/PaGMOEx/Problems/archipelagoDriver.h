@@ -0,0 +1,153 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_ARCHIPELAGO_DRIVER_H
+#define TUDAT_PAGMO_ARCHIPELAGO_DRIVER_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <pagmo/algorithm.hpp>
+#include <pagmo/archipelago.hpp>
+#include <pagmo/population.hpp>
+#include <pagmo/problem.hpp>
+#include <pagmo/topologies/ring.hpp>
+#include <pagmo/topology.hpp>
+#include <pagmo/types.hpp>
+
+namespace tudat_pagmo_applications
+{
+
+//! Function type for output during the evolution of an archipelago, called with the archipelago (all islands idle) and the
+//! number of evolutions performed so far
+typedef std::function< void( const pagmo::archipelago& archipelago, const unsigned int numberOfEvolutions ) >
+ArchipelagoOutputFunction;
+
+//! Function to create an archipelago of identical islands.
+/*!
+ *  Function to create an archipelago of identical islands, each with its own (randomly initialized) population. The islands
+ *  are evolved in parallel (one thread per island for problems with at least basic thread safety), and exchange
+ *  individuals according to the migration topology.
+ *  \param algorithm Algorithm used by each island
+ *  \param problem Problem that is to be optimized
+ *  \param numberOfIslands Number of islands in archipelago
+ *  \param populationSizePerIsland Number of individuals per island
+ *  \param topology Migration topology between islands
+ *  \return Archipelago
+ */
+inline pagmo::archipelago createArchipelago(
+        const pagmo::algorithm& algorithm,
+        const pagmo::problem& problem,
+        const unsigned int numberOfIslands,
+        const pagmo::population::size_type populationSizePerIsland,
+        const pagmo::topology& topology = pagmo::topology( pagmo::ring( ) ) )
+{
+    pagmo::archipelago archipelago;
+    archipelago.set_topology( topology );
+    for( unsigned int i = 0; i < numberOfIslands; i++ )
+    {
+        archipelago.push_back( algorithm, problem, populationSizePerIsland );
+    }
+    return archipelago;
+}
+
+//! Function to evolve an archipelago, synchronizing the islands only when output is due.
+/*!
+ *  Function to evolve an archipelago, synchronizing the islands only when output is due. The islands evolve asynchronously
+ *  (with migration) for evolutionsPerOutput evolutions at a time, after which all islands are waited for, and the output
+ *  function is called. Any error raised during the evolution is rethrown.
+ *  \param archipelago Archipelago that is to be evolved
+ *  \param numberOfEvolutions Total number of evolutions (calls to the evolve function of the algorithm of each island)
+ *  \param evolutionsPerOutput Number of evolutions between calls to the output function (0 for output only at the end)
+ *  \param outputFunction Function that is called when output is due (none if empty)
+ */
+inline void evolveArchipelago(
+        pagmo::archipelago& archipelago,
+        const unsigned int numberOfEvolutions,
+        const unsigned int evolutionsPerOutput = 0,
+        const ArchipelagoOutputFunction outputFunction = ArchipelagoOutputFunction( ) )
+{
+    const unsigned int evolutionsPerSynchronization =
+            ( evolutionsPerOutput > 0 ) ? evolutionsPerOutput : numberOfEvolutions;
+
+    unsigned int numberOfPerformedEvolutions = 0;
+    while( numberOfPerformedEvolutions < numberOfEvolutions )
+    {
+        const unsigned int currentNumberOfEvolutions =
+                std::min( evolutionsPerSynchronization, numberOfEvolutions - numberOfPerformedEvolutions );
+        archipelago.evolve( currentNumberOfEvolutions );
+        archipelago.wait_check( ); // Raises errors
+
+        numberOfPerformedEvolutions += currentNumberOfEvolutions;
+        if( outputFunction )
+        {
+            outputFunction( archipelago, numberOfPerformedEvolutions );
+        }
+    }
+}
+
+//! Function to retrieve the decision vectors of all islands of an archipelago, concatenated in the order of the islands
+inline std::vector< pagmo::vector_double > getArchipelagoDecisionVectors( const pagmo::archipelago& archipelago )
+{
+    std::vector< pagmo::vector_double > decisionVectors;
+    for( const pagmo::island& currentIsland : archipelago )
+    {
+        const std::vector< pagmo::vector_double > islandDecisionVectors = currentIsland.get_population( ).get_x( );
+        decisionVectors.insert( decisionVectors.end( ), islandDecisionVectors.begin( ), islandDecisionVectors.end( ) );
+    }
+    return decisionVectors;
+}
+
+//! Function to retrieve the fitness vectors of all islands of an archipelago, concatenated in the order of the islands
+inline std::vector< pagmo::vector_double > getArchipelagoFitnessVectors( const pagmo::archipelago& archipelago )
+{
+    std::vector< pagmo::vector_double > fitnessVectors;
+    for( const pagmo::island& currentIsland : archipelago )
+    {
+        const std::vector< pagmo::vector_double > islandFitnessVectors = currentIsland.get_population( ).get_f( );
+        fitnessVectors.insert( fitnessVectors.end( ), islandFitnessVectors.begin( ), islandFitnessVectors.end( ) );
+    }
+    return fitnessVectors;
+}
+
+//! Function to retrieve the best champion of all islands of a (single-objective) archipelago
+/*!
+ *  Function to retrieve the best champion of all islands of a (single-objective) archipelago
+ *  \param archipelago Archipelago from which the champion is to be retrieved
+ *  \return Decision vector (first) and fitness (second) of champion
+ */
+inline std::pair< pagmo::vector_double, pagmo::vector_double > getArchipelagoChampion(
+        const pagmo::archipelago& archipelago )
+{
+    if( archipelago.size( ) == 0 )
+    {
+        throw std::runtime_error( "Error when retrieving archipelago champion, archipelago is empty." );
+    }
+
+    const std::vector< pagmo::vector_double > championsFitness = archipelago.get_champions_f( );
+    const std::vector< pagmo::vector_double > championsDecisionVectors = archipelago.get_champions_x( );
+
+    std::size_t bestIslandIndex = 0;
+    for( std::size_t i = 1; i < championsFitness.size( ); i++ )
+    {
+        if( championsFitness.at( i ).at( 0 ) < championsFitness.at( bestIslandIndex ).at( 0 ) )
+        {
+            bestIslandIndex = i;
+        }
+    }
+    return std::make_pair( championsDecisionVectors.at( bestIslandIndex ), championsFitness.at( bestIslandIndex ) );
+}
+
+}
+
+#endif // TUDAT_PAGMO_ARCHIPELAGO_DRIVER_H
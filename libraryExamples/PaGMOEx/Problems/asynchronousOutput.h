@@ -0,0 +1,171 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_ASYNCHRONOUS_OUTPUT_H
+#define TUDAT_PAGMO_ASYNCHRONOUS_OUTPUT_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace tudat_pagmo_applications
+{
+
+//! Queue of output data that is processed (e.g. written to file) by a single background thread.
+/*!
+ *  Queue of output data that is processed (e.g. written to file) by a single background thread, so that the computation
+ *  producing the data (e.g. evolution of the next generation) overlaps with its output. Data is moved into the queue, so
+ *  that move-only types (such as PopulationSnapshot) are supported, and no copies are made. The queue is bounded: when it is
+ *  full, adding data blocks until the background thread has processed an entry, which limits memory use if output is slower
+ *  than computation. Entries are processed in the order in which they were added. An exception thrown by the output
+ *  function stops the processing, and is rethrown by the next call to addOutput or waitForCompletion.
+ */
+template< typename OutputType >
+class AsynchronousOutputQueue
+{
+public:
+
+    //! Constructor, starts the background thread
+    /*!
+     *  Constructor, starts the background thread
+     *  \param outputFunction Function that processes a single entry of the queue (called from the background thread only)
+     *  \param maximumQueueSize Maximum number of entries waiting to be processed
+     */
+    AsynchronousOutputQueue( const std::function< void( OutputType& ) > outputFunction,
+                             const std::size_t maximumQueueSize = 4 ):
+        outputFunction_( outputFunction ), maximumQueueSize_( std::max< std::size_t >( maximumQueueSize, 1 ) ),
+        isFinished_( false ), outputError_( nullptr )
+    {
+        outputThread_ = std::thread( &AsynchronousOutputQueue::processQueue, this );
+    }
+
+    //! Destructor, processes all remaining entries (errors are not reported, use waitForCompletion to check for errors)
+    ~AsynchronousOutputQueue( )
+    {
+        try
+        {
+            waitForCompletion( );
+        }
+        catch( ... )
+        {
+        }
+    }
+
+    AsynchronousOutputQueue( const AsynchronousOutputQueue& ) = delete;
+
+    AsynchronousOutputQueue& operator=( const AsynchronousOutputQueue& ) = delete;
+
+    //! Function to add an entry to the queue, blocking while the queue is full
+    void addOutput( OutputType&& output )
+    {
+        std::unique_lock< std::mutex > lock( queueMutex_ );
+        queueNotFullCondition_.wait( lock, [ this ]( )
+        {
+            return outputQueue_.size( ) < maximumQueueSize_ || outputError_ != nullptr;
+        } );
+
+        if( outputError_ != nullptr )
+        {
+            std::rethrow_exception( outputError_ );
+        }
+        if( isFinished_ )
+        {
+            throw std::runtime_error( "Error, cannot add output to asynchronous output queue after completion." );
+        }
+
+        outputQueue_.push_back( std::move( output ) );
+        queueNotEmptyCondition_.notify_one( );
+    }
+
+    //! Function to wait until all entries have been processed, and stop the background thread (rethrows any output error)
+    void waitForCompletion( )
+    {
+        {
+            std::lock_guard< std::mutex > lock( queueMutex_ );
+            isFinished_ = true;
+        }
+        queueNotEmptyCondition_.notify_one( );
+
+        if( outputThread_.joinable( ) )
+        {
+            outputThread_.join( );
+        }
+
+        std::lock_guard< std::mutex > lock( queueMutex_ );
+        if( outputError_ != nullptr )
+        {
+            std::rethrow_exception( outputError_ );
+        }
+    }
+
+private:
+
+    //! Function executed by the background thread, processing entries until the queue is finished and empty
+    void processQueue( )
+    {
+        while( true )
+        {
+            std::unique_lock< std::mutex > lock( queueMutex_ );
+            queueNotEmptyCondition_.wait( lock, [ this ]( ){ return !outputQueue_.empty( ) || isFinished_; } );
+            if( outputQueue_.empty( ) )
+            {
+                return;
+            }
+
+            OutputType currentOutput = std::move( outputQueue_.front( ) );
+            outputQueue_.pop_front( );
+            queueNotFullCondition_.notify_one( );
+            lock.unlock( );
+
+            try
+            {
+                outputFunction_( currentOutput );
+            }
+            catch( ... )
+            {
+                lock.lock( );
+                outputError_ = std::current_exception( );
+                outputQueue_.clear( );
+                queueNotFullCondition_.notify_all( );
+                return;
+            }
+        }
+    }
+
+    std::function< void( OutputType& ) > outputFunction_;
+
+    std::size_t maximumQueueSize_;
+
+    std::deque< OutputType > outputQueue_;
+
+    std::mutex queueMutex_;
+
+    std::condition_variable queueNotEmptyCondition_;
+
+    std::condition_variable queueNotFullCondition_;
+
+    //! Boolean denoting whether no more entries will be added
+    bool isFinished_;
+
+    //! Exception thrown by the output function (if any)
+    std::exception_ptr outputError_;
+
+    std::thread outputThread_;
+};
+
+}
+
+#endif // TUDAT_PAGMO_ASYNCHRONOUS_OUTPUT_H
@@ -0,0 +1,425 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_BENCHMARK_HARNESS_H
+#define TUDAT_PAGMO_BENCHMARK_HARNESS_H
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <pagmo/algorithm.hpp>
+#include <pagmo/population.hpp>
+#include <pagmo/problem.hpp>
+
+#include "Problems/parallelExecution.h"
+
+namespace tudat_pagmo_applications
+{
+
+//! Single cell of a benchmark matrix: one optimizer, applied to one problem with given settings and random seed.
+/*!
+ *  Single cell of a benchmark matrix: one optimizer, applied to one problem with given settings and random seed. Besides its
+ *  index, the optimizer is identified by its configuration (e.g. see getAlgorithmConfigurationIdentifier), so that results
+ *  stored for a different algorithm or different algorithm settings are not reused.
+ */
+struct BenchmarkCase
+{
+    BenchmarkCase( const unsigned int algorithmIndex = 0,
+                   const unsigned int problemIndex = 0,
+                   const unsigned int numberOfDimensions = 0,
+                   const unsigned int populationSize = 0,
+                   const unsigned int numberOfGenerations = 0,
+                   const unsigned int seed = 0,
+                   const std::string& algorithmConfiguration = "" ):
+        algorithmIndex_( algorithmIndex ), problemIndex_( problemIndex ), numberOfDimensions_( numberOfDimensions ),
+        populationSize_( populationSize ), numberOfGenerations_( numberOfGenerations ), seed_( seed ),
+        algorithmConfiguration_( algorithmConfiguration ){ }
+
+    //! Function to retrieve the settings of the case, excluding the seed (i.e. identifying the case up to its random seed)
+    std::tuple< unsigned int, std::string, unsigned int, unsigned int, unsigned int, unsigned int > getSettings( ) const
+    {
+        return std::make_tuple( algorithmIndex_, algorithmConfiguration_, problemIndex_, numberOfDimensions_,
+                                populationSize_, numberOfGenerations_ );
+    }
+
+    bool operator<( const BenchmarkCase& otherCase ) const
+    {
+        return std::tuple_cat( getSettings( ), std::make_tuple( seed_ ) ) <
+                std::tuple_cat( otherCase.getSettings( ), std::make_tuple( otherCase.seed_ ) );
+    }
+
+    unsigned int algorithmIndex_;
+
+    unsigned int problemIndex_;
+
+    unsigned int numberOfDimensions_;
+
+    unsigned int populationSize_;
+
+    unsigned int numberOfGenerations_;
+
+    unsigned int seed_;
+
+    //! Identifier of the algorithm and its settings (non-empty, without whitespace)
+    std::string algorithmConfiguration_;
+};
+
+//! Function to create an identifier of an algorithm configuration, for use in a BenchmarkCase.
+/*!
+ *  Function to create an identifier of an algorithm configuration, for use in a BenchmarkCase. The identifier consists of the
+ *  given algorithm name, and a hash of the name and settings reported by pagmo (get_name and get_extra_info, with the seed
+ *  set to zero), so that it changes when any setting of the algorithm changes. An optional run tag is appended, to force
+ *  all cases to be recomputed for other changes (e.g. in the problem implementation).
+ *  \param algorithmName Name of the algorithm (without whitespace)
+ *  \param algorithm Algorithm with the settings used in the benchmark
+ *  \param runTag Tag appended to the identifier (without whitespace)
+ *  \return Identifier of the algorithm configuration
+ */
+inline std::string getAlgorithmConfigurationIdentifier( const std::string& algorithmName,
+                                                        const pagmo::algorithm& algorithm,
+                                                        const std::string& runTag = "" )
+{
+    pagmo::algorithm algorithmWithFixedSeed = algorithm;
+    if( algorithmWithFixedSeed.has_set_seed( ) )
+    {
+        algorithmWithFixedSeed.set_seed( 0 );
+    }
+
+    // 64-bit FNV-1a hash, which (unlike std::hash) is identical for all platforms and runs
+    const std::string algorithmDescription = algorithmWithFixedSeed.get_name( ) + algorithmWithFixedSeed.get_extra_info( );
+    std::uint64_t hash = 14695981039346656037ULL;
+    for( unsigned int i = 0; i < algorithmDescription.size( ); i++ )
+    {
+        hash ^= static_cast< unsigned char >( algorithmDescription.at( i ) );
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream identifierStream;
+    identifierStream << algorithmName << "_" << std::hex << std::setw( 16 ) << std::setfill( '0' ) << hash;
+    if( !runTag.empty( ) )
+    {
+        identifierStream << "_" << runTag;
+    }
+    return identifierStream.str( );
+}
+
+//! Summary statistics of the results of a benchmark case over all random seeds
+struct BenchmarkStatistics
+{
+    BenchmarkStatistics( ):
+        numberOfSamples_( 0 ), mean_( std::numeric_limits< double >::quiet_NaN( ) ),
+        standardDeviation_( std::numeric_limits< double >::quiet_NaN( ) ),
+        minimum_( std::numeric_limits< double >::quiet_NaN( ) ), median_( std::numeric_limits< double >::quiet_NaN( ) ),
+        maximum_( std::numeric_limits< double >::quiet_NaN( ) ){ }
+
+    unsigned int numberOfSamples_;
+
+    double mean_;
+
+    //! Sample standard deviation (zero for a single sample)
+    double standardDeviation_;
+
+    double minimum_;
+
+    double median_;
+
+    double maximum_;
+};
+
+//! Function to compute summary statistics of a set of benchmark results
+inline BenchmarkStatistics computeBenchmarkStatistics( std::vector< double > results )
+{
+    BenchmarkStatistics statistics;
+    statistics.numberOfSamples_ = results.size( );
+    if( results.empty( ) )
+    {
+        return statistics;
+    }
+
+    std::sort( results.begin( ), results.end( ) );
+    statistics.minimum_ = results.front( );
+    statistics.maximum_ = results.back( );
+    statistics.median_ = ( results.size( ) % 2 == 1 ) ? results.at( results.size( ) / 2 ) :
+                                                        0.5 * ( results.at( results.size( ) / 2 - 1 ) +
+                                                                results.at( results.size( ) / 2 ) );
+
+    double sum = 0.0;
+    for( unsigned int i = 0; i < results.size( ); i++ )
+    {
+        sum += results.at( i );
+    }
+    statistics.mean_ = sum / static_cast< double >( results.size( ) );
+
+    double sumOfSquaredDeviations = 0.0;
+    for( unsigned int i = 0; i < results.size( ); i++ )
+    {
+        sumOfSquaredDeviations += ( results.at( i ) - statistics.mean_ ) * ( results.at( i ) - statistics.mean_ );
+    }
+    statistics.standardDeviation_ = ( results.size( ) > 1 ) ?
+                std::sqrt( sumOfSquaredDeviations / static_cast< double >( results.size( ) - 1 ) ) : 0.0;
+
+    return statistics;
+}
+
+//! Class to store the results of a benchmark matrix in a text file, so that an interrupted benchmark may be resumed.
+/*!
+ *  Class to store the results of a benchmark matrix in a text file, so that an interrupted benchmark may be resumed. Each
+ *  completed case is appended to the file as a single line (algorithm index, problem index, number of dimensions,
+ *  population size, number of generations, seed, algorithm configuration, champion fitness), and the file is flushed
+ *  immediately. When the store is
+ *  created, the results in an existing file are loaded, so that cases that have already been computed can be skipped. An
+ *  incomplete final line (e.g. from a run that was killed while writing) is removed, and its case is recomputed. Results
+ *  may be added from multiple threads concurrently.
+ */
+class BenchmarkResultStore
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor, loads any existing results and opens the file for appending
+     *  \param filePath Path of results file (directories are created if needed)
+     */
+    BenchmarkResultStore( const std::string& filePath ):
+        filePath_( filePath )
+    {
+        const boost::filesystem::path parentPath = boost::filesystem::path( filePath ).parent_path( );
+        if( !parentPath.empty( ) )
+        {
+            boost::filesystem::create_directories( parentPath );
+        }
+
+        if( boost::filesystem::exists( filePath ) )
+        {
+            loadExistingResults( );
+        }
+
+        fileStream_.open( filePath, std::ios::app );
+        if( !fileStream_ )
+        {
+            throw std::runtime_error( "Error when opening benchmark results file " + filePath );
+        }
+        fileStream_ << std::setprecision( std::numeric_limits< double >::max_digits10 );
+    }
+
+    //! Function to check whether the result of a case is present in the store
+    bool hasResult( const BenchmarkCase& benchmarkCase )
+    {
+        std::lock_guard< std::mutex > lock( storeMutex_ );
+        return results_.count( benchmarkCase ) > 0;
+    }
+
+    //! Function to add the result of a case to the store, and write it to the file
+    void addResult( const BenchmarkCase& benchmarkCase, const double championFitness )
+    {
+        if( benchmarkCase.algorithmConfiguration_.empty( ) ||
+                std::any_of( benchmarkCase.algorithmConfiguration_.begin( ), benchmarkCase.algorithmConfiguration_.end( ),
+                             [ ]( const char character ){ return std::isspace( static_cast< unsigned char >( character ) ); } ) )
+        {
+            throw std::runtime_error( "Error when adding benchmark result, algorithm configuration \"" +
+                                      benchmarkCase.algorithmConfiguration_ + "\" must be non-empty, without whitespace." );
+        }
+
+        std::lock_guard< std::mutex > lock( storeMutex_ );
+        results_[ benchmarkCase ] = championFitness;
+
+        fileStream_ << benchmarkCase.algorithmIndex_ << " " << benchmarkCase.problemIndex_ << " "
+                    << benchmarkCase.numberOfDimensions_ << " " << benchmarkCase.populationSize_ << " "
+                    << benchmarkCase.numberOfGenerations_ << " " << benchmarkCase.seed_ << " "
+                    << benchmarkCase.algorithmConfiguration_ << " " << championFitness << std::endl;
+        if( !fileStream_ )
+        {
+            throw std::runtime_error( "Error when writing benchmark result to " + filePath_ );
+        }
+    }
+
+    //! Function to retrieve the results of a case for all seeds present in the store
+    std::vector< double > getResultsOverSeeds( const BenchmarkCase& benchmarkCase )
+    {
+        std::lock_guard< std::mutex > lock( storeMutex_ );
+        std::vector< double > resultsOverSeeds;
+        for( auto resultIterator = results_.lower_bound( BenchmarkCase(
+                 benchmarkCase.algorithmIndex_, benchmarkCase.problemIndex_, benchmarkCase.numberOfDimensions_,
+                 benchmarkCase.populationSize_, benchmarkCase.numberOfGenerations_, 0,
+                 benchmarkCase.algorithmConfiguration_ ) );
+             resultIterator != results_.end( ) && resultIterator->first.getSettings( ) == benchmarkCase.getSettings( );
+             resultIterator++ )
+        {
+            resultsOverSeeds.push_back( resultIterator->second );
+        }
+        return resultsOverSeeds;
+    }
+
+    //! Function to retrieve the number of results in the store
+    std::size_t getNumberOfResults( )
+    {
+        std::lock_guard< std::mutex > lock( storeMutex_ );
+        return results_.size( );
+    }
+
+private:
+
+    //! Function to load the results from an existing file, discarding an incomplete final line. Lines without algorithm
+    //! configuration (written by earlier versions) cannot be parsed, and are ignored.
+    void loadExistingResults( )
+    {
+        std::uint64_t completeFileSize = 0;
+        {
+            std::ifstream inputStream( filePath_, std::ios::binary );
+            if( !inputStream )
+            {
+                throw std::runtime_error( "Error when reading benchmark results file " + filePath_ );
+            }
+
+            std::string currentLine;
+            while( std::getline( inputStream, currentLine ) && !inputStream.eof( ) )
+            {
+                completeFileSize += currentLine.size( ) + 1;
+
+                std::istringstream lineStream( currentLine );
+                BenchmarkCase currentCase;
+                double championFitness;
+                if( lineStream >> currentCase.algorithmIndex_ >> currentCase.problemIndex_
+                        >> currentCase.numberOfDimensions_ >> currentCase.populationSize_
+                        >> currentCase.numberOfGenerations_ >> currentCase.seed_ >> currentCase.algorithmConfiguration_
+                        >> championFitness )
+                {
+                    results_[ currentCase ] = championFitness;
+                }
+            }
+        }
+
+        // Final line without line ending was not completely written
+        if( boost::filesystem::file_size( filePath_ ) != completeFileSize )
+        {
+            boost::filesystem::resize_file( filePath_, completeFileSize );
+        }
+    }
+
+    std::string filePath_;
+
+    std::ofstream fileStream_;
+
+    //! Results loaded from file or computed during this run, per case
+    std::map< BenchmarkCase, double > results_;
+
+    std::mutex storeMutex_;
+};
+
+//! Function type to create the problem of a benchmark case
+typedef std::function< pagmo::problem( const BenchmarkCase& ) > BenchmarkProblemFunction;
+
+//! Function type to create the algorithm of a benchmark case
+typedef std::function< pagmo::algorithm( const BenchmarkCase& ) > BenchmarkAlgorithmFunction;
+
+//! Function to run a single benchmark case, returning the fitness of the champion of the final population.
+/*!
+ *  Function to run a single benchmark case, returning the fitness of the champion of the final population. The population
+ *  is evolved directly by the algorithm on the calling thread (no island is created), and both the initial population and
+ *  the algorithm are seeded with the seed of the case, so that the result is reproducible and does not depend on the order
+ *  in which the cases are run.
+ *  \param benchmarkCase Case that is to be run
+ *  \param problemFunction Function to create the problem of the case
+ *  \param algorithmFunction Function to create the algorithm of the case
+ *  \return Champion fitness (first objective) after the final generation
+ */
+inline double runBenchmarkCase( const BenchmarkCase& benchmarkCase,
+                                const BenchmarkProblemFunction& problemFunction,
+                                const BenchmarkAlgorithmFunction& algorithmFunction )
+{
+    pagmo::problem problem = problemFunction( benchmarkCase );
+    pagmo::algorithm algorithm = algorithmFunction( benchmarkCase );
+    if( algorithm.has_set_seed( ) )
+    {
+        algorithm.set_seed( benchmarkCase.seed_ );
+    }
+
+    pagmo::population population( problem, benchmarkCase.populationSize_, benchmarkCase.seed_ );
+    for( unsigned int i = 0; i < benchmarkCase.numberOfGenerations_; i++ )
+    {
+        population = algorithm.evolve( population );
+    }
+    return population.champion_f( ).at( 0 );
+}
+
+//! Function to run all cases of a benchmark matrix that are not yet present in a result store, in parallel.
+/*!
+ *  Function to run all cases of a benchmark matrix that are not yet present in a result store, in parallel. Each case is a
+ *  separate task (see executeTasksInParallel), and its result is added to the store as soon as it has been computed, so
+ *  that an interrupted benchmark only loses the cases that were in progress.
+ *  \param benchmarkCases List of all cases in the benchmark matrix
+ *  \param problemFunction Function to create the problem of a case
+ *  \param algorithmFunction Function to create the algorithm of a case
+ *  \param resultStore Store to which the results are added, and from which completed cases are determined
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ *  \param printProgress Boolean denoting whether the result of each case is printed to the console
+ *  \return Number of cases that were computed (i.e. not skipped)
+ */
+inline std::size_t runBenchmark( const std::vector< BenchmarkCase >& benchmarkCases,
+                                 const BenchmarkProblemFunction& problemFunction,
+                                 const BenchmarkAlgorithmFunction& algorithmFunction,
+                                 BenchmarkResultStore& resultStore,
+                                 const unsigned int numberOfThreads = 0,
+                                 const bool printProgress = true )
+{
+    // Determine cases that are still to be computed
+    std::vector< BenchmarkCase > casesToRun;
+    for( unsigned int i = 0; i < benchmarkCases.size( ); i++ )
+    {
+        if( !resultStore.hasResult( benchmarkCases.at( i ) ) )
+        {
+            casesToRun.push_back( benchmarkCases.at( i ) );
+        }
+    }
+
+    if( printProgress )
+    {
+        std::cout << "Running " << casesToRun.size( ) << " of " << benchmarkCases.size( )
+                  << " benchmark cases (others loaded from file)" << std::endl;
+    }
+
+    std::mutex outputMutex;
+    executeTasksInParallel( casesToRun.size( ), [ & ]( const std::size_t taskIndex, const unsigned int )
+    {
+        const BenchmarkCase& currentCase = casesToRun.at( taskIndex );
+        const double championFitness = runBenchmarkCase( currentCase, problemFunction, algorithmFunction );
+        resultStore.addResult( currentCase, championFitness );
+
+        if( printProgress )
+        {
+            std::lock_guard< std::mutex > lock( outputMutex );
+            std::cout << "Minimum: " << currentCase.algorithmConfiguration_ << " " << currentCase.problemIndex_ << " "
+                      << currentCase.numberOfDimensions_ << " " << currentCase.populationSize_ << " "
+                      << currentCase.seed_ << " " << championFitness << std::endl;
+        }
+    }, numberOfThreads );
+
+    return casesToRun.size( );
+}
+
+}
+
+#endif // TUDAT_PAGMO_BENCHMARK_HARNESS_H
@@ -0,0 +1,158 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <cmath>
+
+#include "closestApproachMonitor.h"
+
+//! Function to reset the monitor, before adding the samples of a new propagation
+void ClosestApproachMonitor::reset( const Eigen::Vector3d& targetPosition, const double frameRotationRate )
+{
+    targetPosition_ = targetPosition;
+    frameRotationRate_ = frameRotationRate;
+
+    previousSample_.isSet_ = false;
+    sampleBeforeClosest_.isSet_ = false;
+    sampleAfterClosest_.isSet_ = false;
+    closestSample_.isSet_ = false;
+    closestSample_.time_ = std::numeric_limits< double >::quiet_NaN( );
+    closestSample_.distance_ = std::numeric_limits< double >::infinity( );
+    isSampleAfterClosestPending_ = false;
+}
+
+//! Function to add the inertial Cartesian state of the body at the next epoch of the propagation
+void ClosestApproachMonitor::addSample( const double time, const Eigen::Matrix< double, 6, 1 >& state )
+{
+    Sample currentSample;
+    currentSample.time_ = time;
+    currentSample.state_ = state;
+    currentSample.distance_ = computeDistanceToTarget( time, state.segment< 3 >( 0 ) );
+    currentSample.isSet_ = true;
+
+    if( currentSample.distance_ < closestSample_.distance_ )
+    {
+        sampleBeforeClosest_ = previousSample_;
+        closestSample_ = currentSample;
+        sampleAfterClosest_.isSet_ = false;
+        isSampleAfterClosestPending_ = true;
+    }
+    else if( isSampleAfterClosestPending_ )
+    {
+        sampleAfterClosest_ = currentSample;
+        isSampleAfterClosestPending_ = false;
+    }
+
+    previousSample_ = currentSample;
+}
+
+//! Function to compute the closest approach by interpolation around the closest sample
+double ClosestApproachMonitor::computeRefinedClosestApproach( double& closestApproachTime ) const
+{
+    closestApproachTime = closestSample_.time_;
+    double closestDistance = closestSample_.distance_;
+
+    if( sampleBeforeClosest_.isSet_ )
+    {
+        double intervalClosestApproachTime;
+        const double intervalClosestDistance = minimizeInterpolatedDistance(
+                    sampleBeforeClosest_, closestSample_, intervalClosestApproachTime );
+        if( intervalClosestDistance < closestDistance )
+        {
+            closestDistance = intervalClosestDistance;
+            closestApproachTime = intervalClosestApproachTime;
+        }
+    }
+
+    if( sampleAfterClosest_.isSet_ )
+    {
+        double intervalClosestApproachTime;
+        const double intervalClosestDistance = minimizeInterpolatedDistance(
+                    closestSample_, sampleAfterClosest_, intervalClosestApproachTime );
+        if( intervalClosestDistance < closestDistance )
+        {
+            closestDistance = intervalClosestDistance;
+            closestApproachTime = intervalClosestApproachTime;
+        }
+    }
+
+    return closestDistance;
+}
+
+//! Function to compute the distance to the target of a given inertial position at a given epoch
+double ClosestApproachMonitor::computeDistanceToTarget( const double time, const Eigen::Vector3d& position ) const
+{
+    // Rotate position to rotating frame
+    const double rotationAngle = frameRotationRate_ * time;
+    const double cosineOfAngle = std::cos( rotationAngle );
+    const double sineOfAngle = std::sin( rotationAngle );
+
+    const Eigen::Vector3d separation(
+                cosineOfAngle * position.x( ) + sineOfAngle * position.y( ) - targetPosition_.x( ),
+                -sineOfAngle * position.x( ) + cosineOfAngle * position.y( ) - targetPosition_.y( ),
+                position.z( ) - targetPosition_.z( ) );
+    return separation.norm( );
+}
+
+//! Function to minimize the interpolated distance to the target between two consecutive samples
+double ClosestApproachMonitor::minimizeInterpolatedDistance(
+        const Sample& lowerSample, const Sample& upperSample, double& closestApproachTime ) const
+{
+    const double intervalLength = upperSample.time_ - lowerSample.time_;
+    const Eigen::Vector3d lowerPosition = lowerSample.state_.segment< 3 >( 0 );
+    const Eigen::Vector3d lowerVelocity = lowerSample.state_.segment< 3 >( 3 ) * intervalLength;
+    const Eigen::Vector3d upperPosition = upperSample.state_.segment< 3 >( 0 );
+    const Eigen::Vector3d upperVelocity = upperSample.state_.segment< 3 >( 3 ) * intervalLength;
+
+    // Distance to target, from cubic Hermite interpolation of position at normalized time s in [0,1]
+    auto computeInterpolatedDistance = [ & ]( const double s )
+    {
+        const double s2 = s * s;
+        const double s3 = s2 * s;
+        const Eigen::Vector3d interpolatedPosition =
+                ( 2.0 * s3 - 3.0 * s2 + 1.0 ) * lowerPosition + ( s3 - 2.0 * s2 + s ) * lowerVelocity +
+                ( -2.0 * s3 + 3.0 * s2 ) * upperPosition + ( s3 - s2 ) * upperVelocity;
+        return computeDistanceToTarget( lowerSample.time_ + s * intervalLength, interpolatedPosition );
+    };
+
+    // Golden-section search; interval is reduced to below 1.0E-6 of its original length
+    const double inverseGoldenRatio = 0.5 * ( std::sqrt( 5.0 ) - 1.0 );
+    const int numberOfIterations = 30;
+
+    double lowerBound = 0.0;
+    double upperBound = 1.0;
+    double lowerPoint = upperBound - inverseGoldenRatio * ( upperBound - lowerBound );
+    double upperPoint = lowerBound + inverseGoldenRatio * ( upperBound - lowerBound );
+    double lowerPointDistance = computeInterpolatedDistance( lowerPoint );
+    double upperPointDistance = computeInterpolatedDistance( upperPoint );
+
+    for( int i = 0; i < numberOfIterations; i++ )
+    {
+        if( lowerPointDistance < upperPointDistance )
+        {
+            upperBound = upperPoint;
+            upperPoint = lowerPoint;
+            upperPointDistance = lowerPointDistance;
+            lowerPoint = upperBound - inverseGoldenRatio * ( upperBound - lowerBound );
+            lowerPointDistance = computeInterpolatedDistance( lowerPoint );
+        }
+        else
+        {
+            lowerBound = lowerPoint;
+            lowerPoint = upperPoint;
+            lowerPointDistance = upperPointDistance;
+            upperPoint = lowerBound + inverseGoldenRatio * ( upperBound - lowerBound );
+            upperPointDistance = computeInterpolatedDistance( upperPoint );
+        }
+    }
+
+    const double optimalPoint = 0.5 * ( lowerBound + upperBound );
+    closestApproachTime = lowerSample.time_ + optimalPoint * intervalLength;
+    return computeInterpolatedDistance( optimalPoint );
+}
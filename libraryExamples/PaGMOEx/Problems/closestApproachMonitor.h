@@ -0,0 +1,114 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_CLOSEST_APPROACH_MONITOR_H
+#define TUDAT_EXAMPLE_PAGMO_CLOSEST_APPROACH_MONITOR_H
+
+#include <limits>
+
+#include <Eigen/Core>
+
+//! Monitor for the closest approach of a propagated body to a target that is fixed in a uniformly rotating frame.
+/*!
+ *  Monitor for the closest approach of a propagated body to a target that is fixed in a frame rotating uniformly about the
+ *  z-axis of the inertial frame (e.g. a point fixed w.r.t. the Earth). The (inertial) Cartesian states of the body are
+ *  added one at a time during the propagation, and only the sample closest to the target and its two neighbours are
+ *  retained. After the propagation, the closest approach is refined by a golden-section search on a cubic Hermite
+ *  interpolation of the position between the retained samples.
+ */
+class ClosestApproachMonitor
+{
+public:
+
+    //! Constructor
+    ClosestApproachMonitor( )
+    {
+        reset( Eigen::Vector3d::Zero( ), 0.0 );
+    }
+
+    //! Function to reset the monitor, before adding the samples of a new propagation
+    /*!
+     *  Function to reset the monitor, before adding the samples of a new propagation
+     *  \param targetPosition Position of target in rotating frame (coinciding with inertial frame at t=0)
+     *  \param frameRotationRate Rotation rate of rotating frame about z-axis
+     */
+    void reset( const Eigen::Vector3d& targetPosition, const double frameRotationRate );
+
+    //! Function to add the inertial Cartesian state of the body at the next epoch of the propagation
+    void addSample( const double time, const Eigen::Matrix< double, 6, 1 >& state );
+
+    //! Function to retrieve the smallest distance to the target of all samples added so far (not refined)
+    double getClosestSampledDistance( ) const
+    {
+        return closestSample_.distance_;
+    }
+
+    //! Function to retrieve the distance to the target of the sample that was added most recently
+    double getLatestSampledDistance( ) const
+    {
+        return previousSample_.distance_;
+    }
+
+    //! Function to retrieve the epoch of the sample with the smallest distance to the target (not refined)
+    double getClosestSampledTime( ) const
+    {
+        return closestSample_.time_;
+    }
+
+    //! Function to compute the closest approach by interpolation around the closest sample
+    /*!
+     *  Function to compute the closest approach by interpolation around the closest sample. The interpolated distance is
+     *  minimized on the intervals between the closest sample and its neighbours (where available).
+     *  \param closestApproachTime Epoch of closest approach (returned by reference)
+     *  \return Distance to target at closest approach
+     */
+    double computeRefinedClosestApproach( double& closestApproachTime ) const;
+
+private:
+
+    //! State of body at a single epoch, with its distance to the target
+    struct Sample
+    {
+        double time_;
+
+        Eigen::Matrix< double, 6, 1 > state_;
+
+        double distance_;
+
+        bool isSet_;
+    };
+
+    //! Function to compute the distance to the target of a given inertial position at a given epoch
+    double computeDistanceToTarget( const double time, const Eigen::Vector3d& position ) const;
+
+    //! Function to minimize the interpolated distance to the target between two consecutive samples
+    double minimizeInterpolatedDistance( const Sample& lowerSample, const Sample& upperSample,
+                                         double& closestApproachTime ) const;
+
+    Eigen::Vector3d targetPosition_;
+
+    double frameRotationRate_;
+
+    //! Sample that was added most recently
+    Sample previousSample_;
+
+    //! Sample with the smallest distance to the target
+    Sample closestSample_;
+
+    //! Samples directly before and after the closest sample
+    Sample sampleBeforeClosest_;
+
+    Sample sampleAfterClosest_;
+
+    //! Boolean denoting whether the sample after the closest sample is still to be added
+    bool isSampleAfterClosestPending_;
+};
+
+#endif // TUDAT_EXAMPLE_PAGMO_CLOSEST_APPROACH_MONITOR_H
@@ -12,7 +12,34 @@
 
 EarthMarsTransfer::EarthMarsTransfer( std::vector< std::vector< double > > &bounds,
                                       const bool useTripTime ) :
-    problemBounds_( bounds ), useTripTime_( useTripTime ) { }
+    problemBounds_( bounds ), useTripTime_( useTripTime )
+{
+    // Create ephemeris caches from Keplerian orbits, covering all departure (Earth) and arrival (Mars) epochs within the bounds
+    std::vector< std::shared_ptr< const PlanetEphemerisCache > > ephemerisCaches( 2 );
+    for( int planet = earth_transfer_planet; planet <= mars_transfer_planet; planet++ )
+    {
+        std::function< StateType( const double ) > stateFunction = [ this, planet ]( const double julianDay )
+        {
+            Eigen::Matrix< double, 6, Eigen::Dynamic > planetStates;
+            computePlanetStates( Eigen::ArrayXd::Constant( 1, julianDay ),
+                                 static_cast< EarthMarsTransferPlanet >( planet ), planetStates );
+            return StateType( planetStates.col( 0 ) );
+        };
+
+        if( planet == earth_transfer_planet )
+        {
+            ephemerisCaches[ planet ] = std::make_shared< PlanetEphemerisCache >(
+                        stateFunction, problemBounds_[ 0 ][ 0 ], problemBounds_[ 1 ][ 0 ] );
+        }
+        else
+        {
+            ephemerisCaches[ planet ] = std::make_shared< PlanetEphemerisCache >(
+                        stateFunction, problemBounds_[ 0 ][ 0 ] + problemBounds_[ 0 ][ 1 ],
+                        problemBounds_[ 1 ][ 0 ] + problemBounds_[ 1 ][ 1 ] );
+        }
+    }
+    ephemerisCaches_ = ephemerisCaches;
+}
 
 
 //! Descriptive name of the problem
@@ -29,22 +56,76 @@ std::pair<std::vector<double>, std::vector<double> > EarthMarsTransfer::get_boun
 //! Implementation of the fitness function (return delta-v)
 std::vector<double> EarthMarsTransfer::fitness( const std::vector<double> &xv ) const{
 
-    using tudat::mission_segments::MultiRevolutionLambertTargeterIzzo;
-
     std::vector<double> f;
 
-    // Gravitational parameter of the Sun
-    double mu = 1.32712440018e+20;
-
     // Set initial and final position as those of Earth and Mars at
     // departure and arrival respectively.
 
-    StateType initialState = getPlanetPosition( xv[0], "Earth");
+    StateType initialState = getPlanetPosition( xv[0], earth_transfer_planet );
+
+    StateType finalState   = getPlanetPosition( xv[0] + xv[1], mars_transfer_planet );
+
+    f.push_back( computeMinimumDeltaV( initialState, finalState, xv[1]*86400 ) );
+
+    if( useTripTime_ )
+    {
+        f.push_back( xv[1] );
+    }
+    return f;
+}
+
+//! Implementation of the batch fitness function (return delta-v for each decision vector in batch)
+vector_double EarthMarsTransfer::batch_fitness( const vector_double &xs ) const{
+
+    const vector_double::size_type numberOfParameters = 2;
+    const vector_double::size_type numberOfObjectives = get_nobj( );
+    if( xs.size( ) % numberOfParameters != 0 )
+    {
+        throw std::invalid_argument( "Error in Earth-Mars transfer batch fitness, input size " +
+                                     std::to_string( xs.size( ) ) + " is not a multiple of the problem dimension." );
+    }
+    const vector_double::size_type batchSize = xs.size( ) / numberOfParameters;
+
+    // Collect departure and arrival epochs of all decision vectors
+    Eigen::ArrayXd departureDays( batchSize );
+    Eigen::ArrayXd arrivalDays( batchSize );
+    for( vector_double::size_type i = 0; i < batchSize; i++ )
+    {
+        departureDays( i ) = xs[ i * numberOfParameters ];
+        arrivalDays( i ) = xs[ i * numberOfParameters ] + xs[ i * numberOfParameters + 1 ];
+    }
+
+    // Compute planet states for complete batch at once
+    Eigen::Matrix< double, 6, Eigen::Dynamic > initialStates, finalStates;
+    getPlanetStates( departureDays, earth_transfer_planet, initialStates );
+    getPlanetStates( arrivalDays, mars_transfer_planet, finalStates );
+
+    // Solve Lambert problems for all decision vectors
+    vector_double f( batchSize * numberOfObjectives );
+    for( vector_double::size_type i = 0; i < batchSize; i++ )
+    {
+        const double timeOfFlight = xs[ i * numberOfParameters + 1 ];
+        f[ i * numberOfObjectives ] = computeMinimumDeltaV(
+                    initialStates.col( i ), finalStates.col( i ), timeOfFlight * 86400 );
+        if( useTripTime_ )
+        {
+            f[ i * numberOfObjectives + 1 ] = timeOfFlight;
+        }
+    }
+    return f;
+}
 
-    StateType finalState   = getPlanetPosition( xv[0] + xv[1], "Mars" );
+//! Function to compute the lowest Delta V of all multi-revolution Lambert solutions
+double EarthMarsTransfer::computeMinimumDeltaV( const StateType& initialState, const StateType& finalState,
+                                                const double timeOfFlight ) const{
+
+    using tudat::mission_segments::MultiRevolutionLambertTargeterIzzo;
+
+    // Gravitational parameter of the Sun
+    double mu = 1.32712440018e+20;
 
     MultiRevolutionLambertTargeterIzzo lambertTargeter( initialState.segment(0,3),
-        finalState.segment(0,3), xv[1]*86400, mu );
+        finalState.segment(0,3), timeOfFlight, mu );
 
     double deltaV = std::numeric_limits<double>::infinity();
 
@@ -53,37 +134,73 @@ std::vector<double> EarthMarsTransfer::fitness( const std::vector<double> &xv )
     // Go through all multi-revolution solutions and select the one
     // with the lowest delta-V
     for( unsigned int i = 0; i <= maxrev; ++i){
-	lambertTargeter.computeForRevolutionsAndBranch( i, false );
-	deltaV = std::min( deltaV, ( initialState.segment(3,3)
-		- lambertTargeter.getInertialVelocityAtDeparture( )).norm() +
-	    + ( finalState.segment(3,3)
-		- lambertTargeter.getInertialVelocityAtArrival( )).norm());
+        lambertTargeter.computeForRevolutionsAndBranch( i, false );
+        deltaV = std::min( deltaV, ( initialState.segment(3,3)
+                - lambertTargeter.getInertialVelocityAtDeparture( )).norm() +
+            + ( finalState.segment(3,3)
+                - lambertTargeter.getInertialVelocityAtArrival( )).norm());
     }
 
-    f.push_back(deltaV);
+    return deltaV;
+}
 
-    if( useTripTime_ )
+//! Function to obtain position of Earth and Mars
+EarthMarsTransfer::StateType EarthMarsTransfer::getPlanetPosition( const double date,
+                                                const EarthMarsTransferPlanet planet ) const {
+
+    StateType planetState;
+    if( !ephemerisCaches_.empty( ) && ephemerisCaches_[ planet ]->isJulianDayInRange( date ) )
     {
-        f.push_back( xv[1] );
+        ephemerisCaches_[ planet ]->getState( date, planetState );
     }
-    return f;
+    else
+    {
+        Eigen::Matrix< double, 6, Eigen::Dynamic > planetStates;
+        computePlanetStates( Eigen::ArrayXd::Constant( 1, date ), planet, planetStates );
+        planetState = planetStates.col( 0 );
+    }
+    return planetState;
 }
 
-//! Function to obtain position of Earth and Mars
-EarthMarsTransfer::StateType EarthMarsTransfer::getPlanetPosition( const double date,
-                                                const std::string planetName ) const {
+//! Function to obtain states of Earth or Mars at a set of epochs
+void EarthMarsTransfer::getPlanetStates( const Eigen::ArrayXd& julianDays, const EarthMarsTransferPlanet planet,
+                                         Eigen::Matrix< double, 6, Eigen::Dynamic >& planetStates ) const {
+
+    if( !ephemerisCaches_.empty( ) &&
+            ephemerisCaches_[ planet ]->isJulianDayInRange( julianDays.minCoeff( ) ) &&
+            ephemerisCaches_[ planet ]->isJulianDayInRange( julianDays.maxCoeff( ) ) )
+    {
+        planetStates.resize( 6, julianDays.size( ) );
+        for( int i = 0; i < julianDays.size( ); i++ )
+        {
+            ephemerisCaches_[ planet ]->getState( julianDays( i ), planetStates.col( i ) );
+        }
+    }
+    else
+    {
+        computePlanetStates( julianDays, planet, planetStates );
+    }
+}
 
-    using tudat::orbital_element_conversions::convertKeplerianToCartesianElements;
-    using tudat::orbital_element_conversions::convertMeanAnomalyToEccentricAnomaly;
-    using tudat::orbital_element_conversions::convertEccentricAnomalyToTrueAnomaly;
+//! Function to compute states of Earth or Mars at a set of epochs from their Keplerian orbits, with all epochs processed
+//! simultaneously
+void EarthMarsTransfer::computePlanetStates( const Eigen::ArrayXd& julianDays, const EarthMarsTransferPlanet planet,
+                                             Eigen::Matrix< double, 6, Eigen::Dynamic >& planetStates ) const {
 
+    using tudat::orbital_element_conversions::semiMajorAxisIndex;
+    using tudat::orbital_element_conversions::eccentricityIndex;
+    using tudat::orbital_element_conversions::inclinationIndex;
+    using tudat::orbital_element_conversions::argumentOfPeriapsisIndex;
+    using tudat::orbital_element_conversions::longitudeOfAscendingNodeIndex;
+    using tudat::orbital_element_conversions::trueAnomalyIndex;
 
     // Gravitational parameter of the Sun
     double mu = 1.32712440018e+20;
 
-    StateType stateKepl, stateCart;
+    // Keplerian elements, with mean anomaly at reference epoch as final entry
+    StateType stateKepl;
     double n, jd0;
-    if( planetName == "Earth" ){
+    if( planet == earth_transfer_planet ){
         n   = 1.991e-07;
         jd0 = 2454000.5;
         stateKepl << 1.4960e+11, 1.6717e-02, 0.0, 5.0198e+00, 3.0614e+00, 4.4961e+00;
@@ -92,13 +209,62 @@ EarthMarsTransfer::StateType EarthMarsTransfer::getPlanetPosition( const double
         jd0 = 2451545.0;
         stateKepl << 2.2794e+11, 9.3412e-02, 5.85 * boost::math::constants::pi<double>() / 180.0, 5.8650e+00, 8.6531e-01, 5.7567e+00;
     }
-    stateKepl( 5 ) = convertMeanAnomalyToEccentricAnomaly( stateKepl( 1 ),
-        fmod( stateKepl( 5 ) + ( date - jd0 ) * 86400. * n, 2.*boost::math::constants::pi<double>() ) );
-    stateKepl( 5 ) = convertEccentricAnomalyToTrueAnomaly( stateKepl( 5 ), stateKepl( 1 ) );
-    stateCart = convertKeplerianToCartesianElements( stateKepl , mu );
-    return stateCart;
 
+    const double semiMajorAxis = stateKepl( semiMajorAxisIndex );
+    const double eccentricity = stateKepl( eccentricityIndex );
 
-}
+    // Solve Kepler's equation for all epochs simultaneously (Newton-Raphson)
+    const Eigen::ArrayXd meanAnomalies = ( stateKepl( trueAnomalyIndex ) + ( julianDays - jd0 ) * 86400. * n ).unaryExpr(
+                [ ]( const double meanAnomaly ){ return std::fmod( meanAnomaly, 2.*boost::math::constants::pi<double>() ); } );
+    Eigen::ArrayXd eccentricAnomalies = meanAnomalies + eccentricity * meanAnomalies.sin( );
+    for( int i = 0; i < 20; i++ )
+    {
+        const Eigen::ArrayXd correction = ( eccentricAnomalies - eccentricity * eccentricAnomalies.sin( ) - meanAnomalies ) /
+                ( 1.0 - eccentricity * eccentricAnomalies.cos( ) );
+        eccentricAnomalies -= correction;
+        if( correction.abs( ).maxCoeff( ) < 1.0E-14 )
+        {
+            break;
+        }
+    }
+
+    // Compute position and velocity in perifocal frame
+    const Eigen::ArrayXd cosineEccentricAnomalies = eccentricAnomalies.cos( );
+    const Eigen::ArrayXd sineEccentricAnomalies = eccentricAnomalies.sin( );
+    const double semiMinorAxisRatio = std::sqrt( 1.0 - eccentricity * eccentricity );
+    const Eigen::ArrayXd velocityScaling = std::sqrt( mu * semiMajorAxis ) *
+            ( semiMajorAxis * ( 1.0 - eccentricity * cosineEccentricAnomalies ) ).inverse( );
+
+    Eigen::Matrix< double, 2, Eigen::Dynamic > perifocalPositions( 2, julianDays.size( ) );
+    perifocalPositions.row( 0 ) = ( semiMajorAxis * ( cosineEccentricAnomalies - eccentricity ) ).matrix( ).transpose( );
+    perifocalPositions.row( 1 ) = ( semiMajorAxis * semiMinorAxisRatio * sineEccentricAnomalies ).matrix( ).transpose( );
 
+    Eigen::Matrix< double, 2, Eigen::Dynamic > perifocalVelocities( 2, julianDays.size( ) );
+    perifocalVelocities.row( 0 ) = ( -velocityScaling * sineEccentricAnomalies ).matrix( ).transpose( );
+    perifocalVelocities.row( 1 ) = ( velocityScaling * semiMinorAxisRatio * cosineEccentricAnomalies ).matrix( ).transpose( );
 
+    // Rotate from perifocal to inertial frame; the rotation is identical for all epochs
+    const double cosineInclination = std::cos( stateKepl( inclinationIndex ) );
+    const double sineInclination = std::sin( stateKepl( inclinationIndex ) );
+    const double cosineArgumentOfPeriapsis = std::cos( stateKepl( argumentOfPeriapsisIndex ) );
+    const double sineArgumentOfPeriapsis = std::sin( stateKepl( argumentOfPeriapsisIndex ) );
+    const double cosineLongitudeOfAscendingNode = std::cos( stateKepl( longitudeOfAscendingNodeIndex ) );
+    const double sineLongitudeOfAscendingNode = std::sin( stateKepl( longitudeOfAscendingNodeIndex ) );
+
+    Eigen::Matrix< double, 3, 2 > perifocalToInertialFrame;
+    perifocalToInertialFrame <<
+        cosineLongitudeOfAscendingNode * cosineArgumentOfPeriapsis -
+            sineLongitudeOfAscendingNode * sineArgumentOfPeriapsis * cosineInclination,
+        -cosineLongitudeOfAscendingNode * sineArgumentOfPeriapsis -
+            sineLongitudeOfAscendingNode * cosineArgumentOfPeriapsis * cosineInclination,
+        sineLongitudeOfAscendingNode * cosineArgumentOfPeriapsis +
+            cosineLongitudeOfAscendingNode * sineArgumentOfPeriapsis * cosineInclination,
+        -sineLongitudeOfAscendingNode * sineArgumentOfPeriapsis +
+            cosineLongitudeOfAscendingNode * cosineArgumentOfPeriapsis * cosineInclination,
+        sineArgumentOfPeriapsis * sineInclination,
+        cosineArgumentOfPeriapsis * sineInclination;
+
+    planetStates.resize( 6, julianDays.size( ) );
+    planetStates.topRows( 3 ).noalias( ) = perifocalToInertialFrame * perifocalPositions;
+    planetStates.bottomRows( 3 ).noalias( ) = perifocalToInertialFrame * perifocalVelocities;
+}
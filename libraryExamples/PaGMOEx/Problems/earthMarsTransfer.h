@@ -12,15 +12,23 @@
 #define TUDAT_EXAMPLE_PAGMO_PROBLEM_EARTH_MARS_TRANSFER_H
 
 #include <vector>
+#include <functional>
+#include <memory>
 #include <utility>
 #include <limits>
+#include <string>
+#include <stdexcept>
+#include <cmath>
 
 #include <Eigen/Core>
+#include <boost/math/constants/constants.hpp>
 
 #include <Tudat/Astrodynamics/BasicAstrodynamics/orbitalElementConversions.h>
 #include <Tudat/Astrodynamics/BasicAstrodynamics/convertMeanToEccentricAnomalies.h>
 #include <Tudat/Astrodynamics/MissionSegments/multiRevolutionLambertTargeterIzzo.h>
 
+#include "planetEphemerisCache.h"
+
 #include "pagmo/island.hpp"
 #include "pagmo/io.hpp"
 #include "pagmo/problem.hpp"
@@ -37,6 +45,13 @@
 
 using namespace pagmo;
 
+//! Planets for which the state is computed in the Earth-Mars transfer problem
+enum EarthMarsTransferPlanet
+{
+    earth_transfer_planet = 0,
+    mars_transfer_planet = 1
+};
+
 //! Test function for a new interplanetary trajectory class in Tudat
 struct EarthMarsTransfer
 {
@@ -53,6 +68,15 @@ struct EarthMarsTransfer
     //! Calculate the fitness as a function of the parameter vector x
     std::vector< double > fitness( const std::vector< double > &x ) const;
 
+    //! Calculate the fitness of a batch of parameter vectors, stored contiguously in xs (Pagmo batch fitness interface)
+    vector_double batch_fitness( const vector_double &xs ) const;
+
+    //! Function to denote that the batch fitness interface is implemented
+    bool has_batch_fitness( ) const
+    {
+        return true;
+    }
+
     //! Retrieve the allowable limits of the parameter vector x: pair containing minima and maxima of parameter values
     std::pair< std::vector< double >, std::vector< double > > get_bounds() const;
 
@@ -83,9 +107,26 @@ private:
 
     const std::vector< std::vector< double > > problemBounds_;
 
-    StateType getPlanetPosition( const double date, const std::string planetName ) const;
+    //! Retrieve state of a planet at a given Julian day, interpolated from the ephemeris cache if possible
+    StateType getPlanetPosition( const double date, const EarthMarsTransferPlanet planet ) const;
+
+    //! Retrieve Cartesian states of a planet (columns) at a set of Julian days, interpolated from the ephemeris cache if possible
+    void getPlanetStates( const Eigen::ArrayXd& julianDays, const EarthMarsTransferPlanet planet,
+                          Eigen::Matrix< double, 6, Eigen::Dynamic >& planetStates ) const;
+
+    //! Compute Cartesian states of a planet (columns) at a set of Julian days from its Keplerian orbit
+    void computePlanetStates( const Eigen::ArrayXd& julianDays, const EarthMarsTransferPlanet planet,
+                              Eigen::Matrix< double, 6, Eigen::Dynamic >& planetStates ) const;
+
+    //! Compute minimum Delta V over all multi-revolution Lambert solutions between two states
+    double computeMinimumDeltaV( const StateType& initialState, const StateType& finalState,
+                                 const double timeOfFlight ) const;
 
     bool useTripTime_;
+
+    //! Interpolated ephemerides of Earth and Mars over the problem bounds (indexed by EarthMarsTransferPlanet), shared by
+    //! all copies of the problem. Empty if no bounds are defined.
+    std::vector< std::shared_ptr< const PlanetEphemerisCache > > ephemerisCaches_;
 };
 
 #endif // TUDAT_EXAMPLE_PAGMO_PROBLEM_EARTH_MARS_TRANSFER_H
@@ -0,0 +1,221 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_FIXED_SEQUENCE_MULTIPLE_GRAVITY_ASSIST_H
+#define TUDAT_EXAMPLE_PAGMO_FIXED_SEQUENCE_MULTIPLE_GRAVITY_ASSIST_H
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Tudat/Astrodynamics/Ephemerides/approximatePlanetPositions.h>
+
+#include <pagmo/types.hpp>
+
+#include "mgaTrajectoryWorkspace.h"
+
+//! Constants of a planet in a flyby sequence, with the planet numbering of MultipleGravityAssist (1 = Mercury, ..., 9 = Pluto)
+template< int PlanetNumber >
+struct MgaPlanetConstants;
+
+#define TUDAT_PAGMO_MGA_PLANET_CONSTANTS( planetNumber, ephemerisBody, planetGravitationalParameter, pericenterRadius ) \
+template< > \
+struct MgaPlanetConstants< planetNumber > \
+{ \
+    static constexpr tudat::ephemerides::ApproximatePlanetPositionsBase::BodiesWithEphemerisData getEphemerisBody( ) \
+    { \
+        return tudat::ephemerides::ApproximatePlanetPositionsBase::BodiesWithEphemerisData::ephemerisBody; \
+    } \
+    static constexpr double getGravitationalParameter( ){ return planetGravitationalParameter; } \
+    static constexpr double getMinimumPericenterRadius( ){ return pericenterRadius; } \
+};
+
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 1, mercury, 2.2032E13, 2639.7E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 2, venus, 3.24859E14, 6251.8E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 3, earthMoonBarycenter, 3.986004418E14, 6578.1E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 4, mars, 4.282837E13, 3596.2E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 5, jupiter, 1.26686534E17, 72000.0E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 6, saturn, 3.7931187E16, 61000.0E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 7, uranus, 5.793939E15, 26000.0E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 8, neptune, 6.836529E15, 25000.0E3 )
+TUDAT_PAGMO_MGA_PLANET_CONSTANTS( 9, pluto, 8.71E11, 1395.0E3 )
+
+#undef TUDAT_PAGMO_MGA_PLANET_CONSTANTS
+
+//! Multiple gravity assist (MGA) transfer problem, with a flyby sequence that is fixed at compile time.
+/*!
+ *  Multiple gravity assist (MGA) transfer problem, with a flyby sequence that is fixed at compile time (planet numbering of
+ *  MultipleGravityAssist). The Delta V is computed by computeMgaTrajectoryDeltaV, as by MultipleGravityAssist with a
+ *  trajectory workspace, with the same decision variables (departure epoch and times of flight, in days) and objectives,
+ *  but the planet constants are compile-time constants and all intermediate results are stored in fixed-size Eigen types
+ *  (MgaTrajectoryBuffers< NumberOfLegs >), so that the loops over the legs can be unrolled by the compiler.
+ *
+ *  Optionally, Lambert arc solutions are memoized in a per-thread cache, as described for MultipleGravityAssist.
+ */
+template< int... FlybySequence >
+class FixedSequenceMultipleGravityAssist
+{
+public:
+
+    static constexpr int NumberOfLegs = sizeof...( FlybySequence );
+
+    static_assert( NumberOfLegs >= 2, "Error, MGA flyby sequence must contain at least a departure and capture body." );
+
+    //! Empty constructor
+    FixedSequenceMultipleGravityAssist( ): useTripTime_( false ), lambertCacheEpochResolution_( 0.0 ),
+        maximumNumberOfCachedLambertSolutions_( 0 ),
+        numberOfLambertCacheHits_( std::make_shared< std::atomic< unsigned long long > >( 0 ) ),
+        numberOfLambertCacheLookups_( std::make_shared< std::atomic< unsigned long long > >( 0 ) )
+    {
+        createEphemerides( );
+    }
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param bounds Lower and upper bounds of departure epoch and times of flight (in days)
+     *  \param useTripTime Boolean denoting whether the total time of flight is used as second objective
+     *  \param lambertCacheEpochResolution Resolution (in days) to which epochs are rounded for the memoization of Lambert
+     *  arcs (0 if not used)
+     *  \param maximumNumberOfCachedLambertSolutions Maximum number of Lambert arcs in the cache of each thread
+     */
+    FixedSequenceMultipleGravityAssist( const std::vector< std::vector< double > >& bounds,
+                                        const bool useTripTime = false,
+                                        const double lambertCacheEpochResolution = 0.0,
+                                        const unsigned int maximumNumberOfCachedLambertSolutions = 100000 ):
+        problemBounds_( bounds ), useTripTime_( useTripTime ),
+        lambertCacheEpochResolution_( lambertCacheEpochResolution ),
+        maximumNumberOfCachedLambertSolutions_( maximumNumberOfCachedLambertSolutions ),
+        numberOfLambertCacheHits_( std::make_shared< std::atomic< unsigned long long > >( 0 ) ),
+        numberOfLambertCacheLookups_( std::make_shared< std::atomic< unsigned long long > >( 0 ) )
+    {
+        createEphemerides( );
+    }
+
+    //! Fitness: total Delta V, and (optionally) total time of flight
+    std::vector< double > fitness( const std::vector< double >& xv ) const
+    {
+        double resultingDeltaV = computeDeltaV( xv );
+        if( std::isnan( resultingDeltaV ) )
+        {
+            resultingDeltaV = 1.0E10;
+        }
+
+        if( useTripTime_ )
+        {
+            double TOF = 0;
+            for( int i = 1; i < NumberOfLegs; i++ )
+            {
+                TOF += xv[ i ];
+            }
+            return { resultingDeltaV, TOF };
+        }
+        else
+        {
+            return { resultingDeltaV };
+        }
+    }
+
+    std::pair< std::vector< double >, std::vector< double > > get_bounds( ) const
+    {
+        return { problemBounds_[ 0 ], problemBounds_[ 1 ] };
+    }
+
+    std::string get_name( ) const
+    {
+        return "MGA transfer trajectory (fixed sequence)";
+    }
+
+    pagmo::vector_double::size_type get_nobj( ) const
+    {
+        return useTripTime_ ? 2u : 1u;
+    }
+
+    //! Function to retrieve the fraction of Lambert arcs that was retrieved from the cache (over all copies of the problem)
+    double getLambertCacheHitRate( ) const
+    {
+        const unsigned long long numberOfLookups = *numberOfLambertCacheLookups_;
+        return ( numberOfLookups == 0 ) ? 0.0 :
+                                          static_cast< double >( *numberOfLambertCacheHits_ ) / numberOfLookups;
+    }
+
+private:
+
+    //! Function to create the ephemerides of the bodies in the flyby sequence
+    void createEphemerides( )
+    {
+        ephemerides_ = { { std::make_shared< tudat::ephemerides::ApproximatePlanetPositions >(
+                               MgaPlanetConstants< FlybySequence >::getEphemerisBody( ) )... } };
+    }
+
+    //! Function to compute the total Delta V of the trajectory
+    double computeDeltaV( const std::vector< double >& xv ) const
+    {
+        static constexpr int flybySequence[ NumberOfLegs ] = { FlybySequence... };
+        static constexpr double gravitationalParameters[ NumberOfLegs ] =
+        { MgaPlanetConstants< FlybySequence >::getGravitationalParameter( )... };
+        static constexpr double minimumPericenterRadii[ NumberOfLegs ] =
+        { MgaPlanetConstants< FlybySequence >::getMinimumPericenterRadius( )... };
+
+        // Lambert arcs are cached per thread (with the maximum number of solutions set when the cache is created)
+        const bool useLambertSolutionCache = ( lambertCacheEpochResolution_ > 0.0 );
+        LambertSolutionCache* lambertSolutionCache = nullptr;
+        unsigned long long previousNumberOfHits = 0;
+        if( useLambertSolutionCache )
+        {
+            lambertSolutionCache = &getThreadLocalLambertSolutionCache( maximumNumberOfCachedLambertSolutions_ );
+            previousNumberOfHits = lambertSolutionCache->getNumberOfHits( );
+        }
+
+        MgaTrajectoryBuffers< NumberOfLegs > buffers;
+        const double totalDeltaV = computeMgaTrajectoryDeltaV(
+                    buffers, xv, ephemerides_, gravitationalParameters, minimumPericenterRadii,
+                    getMgaDepartureSemiMajorAxis( ), getMgaDepartureEccentricity( ),
+                    getMgaCaptureSemiMajorAxis( ), getMgaCaptureEccentricity( ), getMgaSunGravitationalParameter( ),
+                    flybySequence, lambertSolutionCache, lambertCacheEpochResolution_ );
+
+        if( useLambertSolutionCache )
+        {
+            *numberOfLambertCacheHits_ += lambertSolutionCache->getNumberOfHits( ) - previousNumberOfHits;
+            *numberOfLambertCacheLookups_ += NumberOfLegs - 1;
+        }
+
+        return totalDeltaV;
+    }
+
+    std::vector< std::vector< double > > problemBounds_;
+
+    bool useTripTime_;
+
+    //! Resolution (in days) of epochs for Lambert arc memoization (0 if not used)
+    double lambertCacheEpochResolution_;
+
+    unsigned int maximumNumberOfCachedLambertSolutions_;
+
+    //! Number of Lambert arcs retrieved from cache, and number of cache lookups, shared by all copies of the problem
+    std::shared_ptr< std::atomic< unsigned long long > > numberOfLambertCacheHits_;
+
+    std::shared_ptr< std::atomic< unsigned long long > > numberOfLambertCacheLookups_;
+
+    //! Ephemerides of the bodies in the flyby sequence
+    std::array< std::shared_ptr< tudat::ephemerides::ApproximatePlanetPositions >, NumberOfLegs > ephemerides_;
+};
+
+template< int... FlybySequence >
+constexpr int FixedSequenceMultipleGravityAssist< FlybySequence... >::NumberOfLegs;
+
+//! MGA transfer problem with Earth-Venus-Earth-Earth-Jupiter flyby sequence
+typedef FixedSequenceMultipleGravityAssist< 3, 2, 3, 3, 5 > EveejMultipleGravityAssist;
+
+#endif // TUDAT_EXAMPLE_PAGMO_FIXED_SEQUENCE_MULTIPLE_GRAVITY_ASSIST_H
@@ -1,4 +1,13 @@
+#ifndef TUDAT_PAGMO_GET_ALGORITHM_H
+#define TUDAT_PAGMO_GET_ALGORITHM_H
+
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "pagmo/algorithms/de1220.hpp"
 #include "pagmo/algorithms/pso.hpp"
@@ -8,118 +17,275 @@
 #include "pagmo/algorithms/sea.hpp"
 #include "pagmo/algorithms/sade.hpp"
 #include "pagmo/algorithms/simulated_annealing.hpp"
-#include "pagmo/algorithms/bee_colony.hpp"
 #include "pagmo/algorithms/cmaes.hpp"
 #include "pagmo/algorithms/nlopt.hpp"
 #include "pagmo/algorithms/ihs.hpp"
 #include "pagmo/algorithms/xnes.hpp"
 #include "pagmo/algorithms/nsga2.hpp"
 #include "pagmo/algorithms/moead.hpp"
-#include "pagmo/algorithms/ihs.hpp"
 #include "pagmo/algorithms/gaco.hpp"
+#include "pagmo/batch_evaluators/member_bfe.hpp"
+#include "pagmo/bfe.hpp"
+#include "pagmo/rng.hpp"
+
+//! Settings of an algorithm, as a map from parameter name to value.
+/*!
+ *  Settings of an algorithm, as a map from parameter name to value. Parameters that are not provided take the default value
+ *  of the corresponding pagmo algorithm, with the exception of the seed, which is drawn from pagmo::random_device (as is
+ *  done by pagmo itself). All algorithms accept "seed" and (except simulated_annealing) "generations", the number of
+ *  generations performed by a single call to evolve. Increasing the latter makes each evolution of an island a larger unit
+ *  of work, so that the overhead of scheduling an evolution (and of migration) becomes negligible.
+ */
+typedef std::map< std::string, double > AlgorithmParameters;
 
-pagmo::algorithm getMultiObjectiveAlgorithm( const int index )
+//! Class to retrieve algorithm parameters from an AlgorithmParameters map, checking that all provided parameters are used.
+class AlgorithmParameterReader
 {
-    switch( index )
-    {
-    case 0:
+public:
+
+    AlgorithmParameterReader( const std::string& algorithmName, const AlgorithmParameters& parameters ):
+        algorithmName_( algorithmName ), parameters_( parameters ){ }
+
+    //! Function to retrieve a parameter, or its default value if it is not provided
+    double get( const std::string& parameterName, const double defaultValue )
     {
-        pagmo::algorithm algo{ pagmo::nsga2( ) };
-        return algo;
-        break;
+        usedParameters_.push_back( parameterName );
+        if( parameters_.count( parameterName ) == 0 )
+        {
+            return defaultValue;
+        }
+        return parameters_.at( parameterName );
     }
-    case 1:
+
+    //! Function to retrieve an unsigned integer parameter (e.g. number of generations), or its default value
+    unsigned int getUnsigned( const std::string& parameterName, const unsigned int defaultValue )
     {
-        pagmo::algorithm algo{ pagmo::moead( ) };
-        return algo;
-        break;
+        const double parameterValue = get( parameterName, defaultValue );
+        if( parameterValue < 0.0 || parameterValue != static_cast< double >( static_cast< unsigned int >( parameterValue ) ) )
+        {
+            throw std::runtime_error( "Error, parameter " + parameterName + " of pagmo algorithm " + algorithmName_ +
+                                      " must be a non-negative integer." );
+        }
+        return static_cast< unsigned int >( parameterValue );
     }
-    case 2:
+
+    //! Function to retrieve the random seed, drawn from pagmo::random_device if it is not provided
+    unsigned int getSeed( )
     {
-        pagmo::algorithm algo{ pagmo::ihs( ) };
-        return algo;
-        break;
+        if( parameters_.count( "seed" ) == 0 )
+        {
+            usedParameters_.push_back( "seed" );
+            return pagmo::random_device::next( );
+        }
+        return getUnsigned( "seed", 0 );
     }
-    default:
+
+    //! Function to check that all provided parameters have been retrieved (i.e. are supported by the algorithm)
+    void checkAllParametersUsed( ) const
     {
-        throw std::runtime_error( "Error, multi-objective pagmo algorithm " + std::to_string( index ) + " was not found." );
+        for( auto parameterIterator : parameters_ )
+        {
+            if( std::find( usedParameters_.begin( ), usedParameters_.end( ), parameterIterator.first ) ==
+                    usedParameters_.end( ) )
+            {
+                throw std::runtime_error( "Error, parameter " + parameterIterator.first + " is not supported by pagmo algorithm " +
+                                          algorithmName_ + "." );
+            }
+        }
     }
-    }
-}
-pagmo::algorithm getAlgorithm( const int index )
+
+private:
+
+    std::string algorithmName_;
+
+    AlgorithmParameters parameters_;
+
+    std::vector< std::string > usedParameters_;
+};
+
+//! Function type to create an algorithm, retrieving its settings from a parameter reader
+typedef std::function< pagmo::algorithm( AlgorithmParameterReader& ) > AlgorithmFactory;
+
+//! Function to retrieve the registry of all available algorithms, mapping the (pagmo) name of each algorithm to its factory
+inline const std::map< std::string, AlgorithmFactory >& getAlgorithmRegistry( )
 {
-    switch( index )
-    {
-    case 0:
-    {
-        pagmo::algorithm algo{ pagmo::de( ) };
-        return algo;
-        break;
-    }
-    case 1:
-    {
-        pagmo::algorithm algo{ pagmo::sade( ) };
-        return algo;
-        break;
-    }
-    case 2:
-    {
-        pagmo::algorithm algo{ pagmo::de1220( ) };
-        return algo;
-        break;
-    }
-    case 3:
-    {
-        pagmo::algorithm algo{ pagmo::pso( ) };
-        return algo;
-        break;
-    }
-    case 4:
-    {
-        pagmo::algorithm algo{ pagmo::sea( ) };
-        return algo;
-        break;
-    }
-    case 5:
+    static const std::map< std::string, AlgorithmFactory > algorithmRegistry =
     {
-        pagmo::algorithm algo{ pagmo::sga( ) };
-        return algo;
-        break;
-    }
-    case 6:
-    {
-        pagmo::algorithm algo{ pagmo::simulated_annealing( ) };
-        return algo;
-        break;
-    }
-    case 7:
+        { "de", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::de algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "F", 0.8 ), reader.get( "CR", 0.9 ),
+                                   reader.getUnsigned( "variant", 2 ), reader.get( "ftol", 1.0E-6 ),
+                                   reader.get( "xtol", 1.0E-6 ), reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "sade", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::sade algorithm( reader.getUnsigned( "generations", 1 ), reader.getUnsigned( "variant", 2 ),
+                                     reader.getUnsigned( "variant_adptv", 1 ), reader.get( "ftol", 1.0E-6 ),
+                                     reader.get( "xtol", 1.0E-6 ), reader.get( "memory", 0.0 ) != 0.0, reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "de1220", [ ]( AlgorithmParameterReader& reader )
+          {
+              // Default set of mutation variants of pagmo::de1220
+              pagmo::de1220 algorithm( reader.getUnsigned( "generations", 1 ), { 2u, 3u, 7u, 10u, 13u, 14u, 15u, 16u },
+                                       reader.getUnsigned( "variant_adptv", 1 ), reader.get( "ftol", 1.0E-6 ),
+                                       reader.get( "xtol", 1.0E-6 ), reader.get( "memory", 0.0 ) != 0.0, reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "pso", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::pso algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "omega", 0.7298 ),
+                                    reader.get( "eta1", 2.05 ), reader.get( "eta2", 2.05 ), reader.get( "max_vel", 0.5 ),
+                                    reader.getUnsigned( "variant", 5 ), reader.getUnsigned( "neighb_type", 2 ),
+                                    reader.getUnsigned( "neighb_param", 4 ), reader.get( "memory", 0.0 ) != 0.0,
+                                    reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "sea", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::sea algorithm( reader.getUnsigned( "generations", 1 ), reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "sga", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::sga algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "cr", 0.9 ), reader.get( "eta_c", 1.0 ),
+                                    reader.get( "m", 0.02 ), reader.get( "param_m", 1.0 ), reader.getUnsigned( "param_s", 2 ),
+                                    "exponential", "polynomial", "tournament", reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "simulated_annealing", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::simulated_annealing algorithm(
+                          reader.get( "Ts", 10.0 ), reader.get( "Tf", 0.1 ), reader.getUnsigned( "n_T_adj", 10 ),
+                          reader.getUnsigned( "n_range_adj", 1 ), reader.getUnsigned( "bin_size", 20 ),
+                          reader.get( "start_range", 1.0 ), reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "bee_colony", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::bee_colony algorithm( reader.getUnsigned( "generations", 1 ), reader.getUnsigned( "limit", 20 ),
+                                           reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "cmaes", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::cmaes algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "cc", -1.0 ), reader.get( "cs", -1.0 ),
+                                      reader.get( "c1", -1.0 ), reader.get( "cmu", -1.0 ), reader.get( "sigma0", 0.5 ),
+                                      reader.get( "ftol", 1.0E-6 ), reader.get( "xtol", 1.0E-6 ),
+                                      reader.get( "memory", 0.0 ) != 0.0, reader.get( "force_bounds", 0.0 ) != 0.0,
+                                      reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "ihs", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::ihs algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "phmcr", 0.85 ),
+                                    reader.get( "ppar_min", 0.35 ), reader.get( "ppar_max", 0.99 ),
+                                    reader.get( "bw_min", 1.0E-5 ), reader.get( "bw_max", 1.0 ), reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "xnes", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::xnes algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "eta_mu", -1.0 ),
+                                     reader.get( "eta_sigma", -1.0 ), reader.get( "eta_b", -1.0 ), reader.get( "sigma0", -1.0 ),
+                                     reader.get( "ftol", 1.0E-6 ), reader.get( "xtol", 1.0E-6 ),
+                                     reader.get( "memory", 0.0 ) != 0.0, reader.get( "force_bounds", 0.0 ) != 0.0,
+                                     reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "nsga2", [ ]( AlgorithmParameterReader& reader )
+          {
+              pagmo::nsga2 algorithm( reader.getUnsigned( "generations", 1 ), reader.get( "cr", 0.95 ),
+                                      reader.get( "eta_c", 10.0 ), reader.get( "m", 0.01 ), reader.get( "eta_m", 50.0 ),
+                                      reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } },
+        { "moead", [ ]( AlgorithmParameterReader& reader )
+          {
+              // Number of neighbours must be smaller than population size
+              pagmo::moead algorithm( reader.getUnsigned( "generations", 1 ), "grid", "tchebycheff",
+                                      reader.getUnsigned( "neighbours", 20 ), reader.get( "CR", 1.0 ), reader.get( "F", 0.5 ),
+                                      reader.get( "eta_m", 20.0 ), reader.get( "realb", 0.9 ), reader.getUnsigned( "limit", 2 ),
+                                      reader.get( "preserve_diversity", 1.0 ) != 0.0, reader.getSeed( ) );
+              return pagmo::algorithm{ algorithm };
+          } }
+    };
+    return algorithmRegistry;
+}
+
+//! Function to create an algorithm by name (see getAlgorithmRegistry), with given settings
+inline pagmo::algorithm createAlgorithm( const std::string& algorithmName,
+                                         const AlgorithmParameters& parameters = AlgorithmParameters( ) )
+{
+    const std::map< std::string, AlgorithmFactory >& algorithmRegistry = getAlgorithmRegistry( );
+    if( algorithmRegistry.count( algorithmName ) == 0 )
     {
-        pagmo::algorithm algo{ pagmo::bee_colony( ) };
-        return algo;
-        break;
+        throw std::runtime_error( "Error, pagmo algorithm " + algorithmName + " was not found in algorithm registry." );
     }
-    case 8:
+    AlgorithmParameterReader parameterReader( algorithmName, parameters );
+    pagmo::algorithm algorithm = algorithmRegistry.at( algorithmName )( parameterReader );
+    parameterReader.checkAllParametersUsed( );
+    return algorithm;
+}
+
+//! Function to retrieve the names of the single-objective algorithms, in the order of their index in getAlgorithm
+inline const std::vector< std::string >& getSingleObjectiveAlgorithmNames( )
+{
+    static const std::vector< std::string > algorithmNames =
+    { "de", "sade", "de1220", "pso", "sea", "sga", "simulated_annealing", "bee_colony", "cmaes", "ihs", "xnes" };
+    return algorithmNames;
+}
+
+//! Function to retrieve the names of the multi-objective algorithms, in the order of their index in
+//! getMultiObjectiveAlgorithm
+inline const std::vector< std::string >& getMultiObjectiveAlgorithmNames( )
+{
+    static const std::vector< std::string > algorithmNames = { "nsga2", "moead", "ihs" };
+    return algorithmNames;
+}
+
+inline pagmo::algorithm getMultiObjectiveAlgorithm( const int index,
+                                                    const AlgorithmParameters& parameters = AlgorithmParameters( ) )
+{
+    if( index < 0 || index >= static_cast< int >( getMultiObjectiveAlgorithmNames( ).size( ) ) )
     {
-        pagmo::algorithm algo{ pagmo::cmaes( ) };
-        return algo;
-        break;
+        throw std::runtime_error( "Error, multi-objective pagmo algorithm " + std::to_string( index ) + " was not found." );
     }
-    case 9:
+    return createAlgorithm( getMultiObjectiveAlgorithmNames( ).at( index ), parameters );
+}
+
+inline pagmo::algorithm getAlgorithm( const int index,
+                                      const AlgorithmParameters& parameters = AlgorithmParameters( ) )
+{
+    if( index < 0 || index >= static_cast< int >( getSingleObjectiveAlgorithmNames( ).size( ) ) )
     {
-        pagmo::algorithm algo{ pagmo::ihs( ) };
-        return algo;
-        break;
+        throw std::runtime_error( "Error, single-objective pagmo algorithm " + std::to_string( index ) + " was not found." );
     }
-    case 10:
+    return createAlgorithm( getSingleObjectiveAlgorithmNames( ).at( index ), parameters );
+}
+
+//! Function to let an algorithm evaluate its populations through the batch fitness of the problem, if both support it.
+/*!
+ *  Function to let an algorithm evaluate its populations through the batch fitness of the problem (using a
+ *  pagmo::member_bfe), if the problem implements the batch fitness interface and the algorithm supports batch fitness
+ *  evaluators (nsga2). Other algorithms are not modified.
+ *  \param algorithm Algorithm that is to be modified
+ *  \param problem Problem that is to be optimized by the algorithm
+ *  \return True if a batch fitness evaluator was set
+ */
+inline bool setBatchFitnessEvaluator( pagmo::algorithm& algorithm, const pagmo::problem& problem )
+{
+    if( !problem.has_batch_fitness( ) )
     {
-        pagmo::algorithm algo{ pagmo::xnes( ) };
-        return algo;
-        break;
+        return false;
     }
-    default:
+
+    if( pagmo::nsga2* nsga2Algorithm = algorithm.extract< pagmo::nsga2 >( ) )
     {
-        throw std::runtime_error( "Error, sinlge-objective pagmo algorithm " + std::to_string( index ) + " was not found." );
-    }
+        nsga2Algorithm->set_bfe( pagmo::bfe{ pagmo::member_bfe{ } } );
+        return true;
     }
+    return false;
 }
 
+#endif // TUDAT_PAGMO_GET_ALGORITHM_H
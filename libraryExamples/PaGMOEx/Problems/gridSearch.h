@@ -0,0 +1,222 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_GRID_SEARCH_H
+#define TUDAT_PAGMO_GRID_SEARCH_H
+
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pagmo/problem.hpp>
+#include <pagmo/threading.hpp>
+
+#include "parallelExecution.h"
+
+namespace tudat_pagmo_applications
+{
+
+//! Function type for grid search progress reports, with number of evaluated grid points and total number of grid points
+typedef std::function< void( const std::size_t numberOfEvaluatedPoints, const std::size_t totalNumberOfPoints ) >
+GridSearchProgressFunction;
+
+//! Results of an N-dimensional grid search.
+/*!
+ *  Results of an N-dimensional grid search. The fitness values are stored contiguously, with the index of the final
+ *  dimension running fastest (i.e. row-major for a two-dimensional grid).
+ */
+struct GridSearchResult
+{
+    //! Values of the decision variables along each grid dimension
+    std::vector< std::vector< double > > dataPoints_;
+
+    //! First objective of the fitness, for all grid points
+    std::vector< double > fitnessValues_;
+
+    //! Retrieve the number of grid points along a given dimension
+    std::size_t getNumberOfPoints( const unsigned int dimension ) const
+    {
+        return dataPoints_.at( dimension ).size( );
+    }
+
+    //! Retrieve the flattened index of a grid point from the indices along each dimension
+    std::size_t getFlattenedIndex( const std::vector< std::size_t >& gridIndices ) const
+    {
+        std::size_t flattenedIndex = 0;
+        for( unsigned int i = 0; i < dataPoints_.size( ); i++ )
+        {
+            flattenedIndex = flattenedIndex * dataPoints_.at( i ).size( ) + gridIndices.at( i );
+        }
+        return flattenedIndex;
+    }
+
+    //! Retrieve the fitness at a grid point from the indices along each dimension
+    double getFitness( const std::vector< std::size_t >& gridIndices ) const
+    {
+        return fitnessValues_.at( getFlattenedIndex( gridIndices ) );
+    }
+};
+
+//! Function to create the problem copies to be used by the threads of a parallel evaluation.
+/*!
+ *  Function to create the problem copies to be used by the threads of a parallel evaluation. Problems that are not thread-safe
+ *  are evaluated on a single thread (numberOfThreads is set to 1), problems with basic thread safety are copied for each thread.
+ *  For problems with constant thread safety, no copies are made (empty vector is returned) and the problem can be shared.
+ *  \param problem Problem that is to be evaluated
+ *  \param numberOfThreads Requested number of threads (0 for all available hardware threads), modified by this function
+ *  to the number of threads that is to be used
+ *  \return Copies of problem, one per thread, or empty vector if problem can be shared between threads
+ */
+inline std::vector< pagmo::problem > createThreadProblemCopies(
+        const pagmo::problem& problem, unsigned int& numberOfThreads )
+{
+    numberOfThreads = getNumberOfThreadsToUse( numberOfThreads );
+    if( problem.get_thread_safety( ) == pagmo::thread_safety::none )
+    {
+        numberOfThreads = 1;
+    }
+
+    std::vector< pagmo::problem > problemCopies;
+    if( problem.get_thread_safety( ) == pagmo::thread_safety::basic )
+    {
+        problemCopies.resize( numberOfThreads, problem );
+    }
+    return problemCopies;
+}
+
+//! Function to evaluate the first objective of a problem on a uniform N-dimensional grid, using multiple threads.
+/*!
+ *  Function to evaluate the first objective of a problem on a uniform N-dimensional grid, using multiple threads. The grid is
+ *  split into tiles of consecutive points (by default one tile per set of points along the final dimension), which are
+ *  distributed over the threads with work stealing (see executeTasksInParallel). The problem is copied or shared between
+ *  threads, depending on its thread safety (see createThreadProblemCopies). For problems that implement the batch fitness
+ *  interface, each tile is evaluated with a single call to the batch fitness.
+ *  \param problem Problem for which the grid search is performed
+ *  \param bounds Bounds of grid (lower bounds as first entry, upper bounds as second), one entry per grid dimension
+ *  \param numberOfPoints Number of grid points per dimension
+ *  \param progressFunction Function that is called after each evaluated tile (none if empty)
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ *  \param tileSize Number of grid points per tile (0 for number of points along final dimension)
+ *  \return Grid search results
+ */
+inline GridSearchResult performGridSearch(
+        const pagmo::problem& problem,
+        const std::vector< std::vector< double > >& bounds,
+        const std::vector< int >& numberOfPoints,
+        const GridSearchProgressFunction progressFunction = GridSearchProgressFunction( ),
+        const unsigned int numberOfThreads = 0,
+        const std::size_t tileSize = 0 )
+{
+    const unsigned int numberOfDimensions = static_cast< unsigned int >( numberOfPoints.size( ) );
+    if( bounds.size( ) != 2 || bounds.at( 0 ).size( ) != numberOfDimensions || bounds.at( 1 ).size( ) != numberOfDimensions )
+    {
+        throw std::runtime_error( "Error in grid search, bounds are inconsistent with number of grid dimensions." );
+    }
+    if( problem.get_nx( ) != numberOfDimensions )
+    {
+        throw std::runtime_error( "Error in grid search, problem size " + std::to_string( problem.get_nx( ) ) +
+                                  " does not match number of grid dimensions " + std::to_string( numberOfDimensions ) );
+    }
+
+    // Create data points along each dimension
+    GridSearchResult gridSearchResult;
+    gridSearchResult.dataPoints_.resize( numberOfDimensions );
+    std::size_t totalNumberOfPoints = 1;
+    for( unsigned int i = 0; i < numberOfDimensions; i++ )
+    {
+        if( numberOfPoints.at( i ) < 2 )
+        {
+            throw std::runtime_error( "Error in grid search, at least 2 points are required per dimension." );
+        }
+        const double spacing = ( bounds[ 1 ][ i ] - bounds[ 0 ][ i ] ) / static_cast< double >( numberOfPoints.at( i ) - 1 );
+        for( int j = 0; j < numberOfPoints.at( i ); j++ )
+        {
+            gridSearchResult.dataPoints_[ i ].push_back( bounds[ 0 ][ i ] + static_cast< double >( j ) * spacing );
+        }
+        totalNumberOfPoints *= static_cast< std::size_t >( numberOfPoints.at( i ) );
+    }
+    gridSearchResult.fitnessValues_.resize( totalNumberOfPoints );
+
+    // Set tiles and threads
+    const std::size_t pointsPerTile = ( tileSize > 0 ) ? tileSize :
+                                                         static_cast< std::size_t >( numberOfPoints.back( ) );
+    const std::size_t numberOfTiles = ( totalNumberOfPoints + pointsPerTile - 1 ) / pointsPerTile;
+
+    unsigned int numberOfThreadsToUse = numberOfThreads;
+    const std::vector< pagmo::problem > problemCopies = createThreadProblemCopies( problem, numberOfThreadsToUse );
+
+    std::mutex progressMutex;
+    std::size_t numberOfEvaluatedPoints = 0;
+
+    executeTasksInParallel(
+                numberOfTiles,
+                [ & ]( const std::size_t tileIndex, const unsigned int threadIndex )
+    {
+        const pagmo::problem& problemToEvaluate =
+                problemCopies.empty( ) ? problem : problemCopies.at( threadIndex );
+
+        const std::size_t tileStart = tileIndex * pointsPerTile;
+        const std::size_t tileEnd = std::min( tileStart + pointsPerTile, totalNumberOfPoints );
+
+        // Retrieve decision vector from flattened index (final dimension running fastest)
+        auto setDecisionVector = [ & ]( const std::size_t flattenedIndex, double* decisionVector )
+        {
+            std::size_t remainingIndex = flattenedIndex;
+            for( int i = static_cast< int >( numberOfDimensions ) - 1; i >= 0; i-- )
+            {
+                const std::size_t currentNumberOfPoints = gridSearchResult.dataPoints_[ i ].size( );
+                decisionVector[ i ] = gridSearchResult.dataPoints_[ i ][ remainingIndex % currentNumberOfPoints ];
+                remainingIndex /= currentNumberOfPoints;
+            }
+        };
+
+        if( problemToEvaluate.has_batch_fitness( ) )
+        {
+            // Evaluate all points of the tile with a single call to the batch fitness
+            pagmo::vector_double decisionVectors( ( tileEnd - tileStart ) * numberOfDimensions );
+            for( std::size_t flattenedIndex = tileStart; flattenedIndex < tileEnd; flattenedIndex++ )
+            {
+                setDecisionVector( flattenedIndex, &decisionVectors[ ( flattenedIndex - tileStart ) * numberOfDimensions ] );
+            }
+
+            const pagmo::vector_double fitnessVectors = problemToEvaluate.batch_fitness( decisionVectors );
+            const pagmo::vector_double::size_type numberOfFitnessEntries = problemToEvaluate.get_nf( );
+            for( std::size_t flattenedIndex = tileStart; flattenedIndex < tileEnd; flattenedIndex++ )
+            {
+                gridSearchResult.fitnessValues_[ flattenedIndex ] =
+                        fitnessVectors.at( ( flattenedIndex - tileStart ) * numberOfFitnessEntries );
+            }
+        }
+        else
+        {
+            pagmo::vector_double decisionVector( numberOfDimensions );
+            for( std::size_t flattenedIndex = tileStart; flattenedIndex < tileEnd; flattenedIndex++ )
+            {
+                setDecisionVector( flattenedIndex, decisionVector.data( ) );
+                gridSearchResult.fitnessValues_[ flattenedIndex ] = problemToEvaluate.fitness( decisionVector ).at( 0 );
+            }
+        }
+
+        if( progressFunction )
+        {
+            std::lock_guard< std::mutex > lock( progressMutex );
+            numberOfEvaluatedPoints += tileEnd - tileStart;
+            progressFunction( numberOfEvaluatedPoints, totalNumberOfPoints );
+        }
+    }, numberOfThreadsToUse );
+
+    return gridSearchResult;
+}
+
+}
+
+#endif // TUDAT_PAGMO_GRID_SEARCH_H
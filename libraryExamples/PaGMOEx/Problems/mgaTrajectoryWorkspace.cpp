@@ -0,0 +1,117 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "mgaTrajectoryWorkspace.h"
+
+//! Function to set the maximum number of solutions, discarding the least recently used solutions if required
+void LambertSolutionCache::setMaximumNumberOfSolutions( const std::size_t maximumNumberOfSolutions )
+{
+    maximumNumberOfSolutions_ = maximumNumberOfSolutions;
+    while( solutions_.size( ) > maximumNumberOfSolutions_ )
+    {
+        solutionsByKey_.erase( solutions_.back( ).first );
+        solutions_.pop_back( );
+    }
+}
+
+//! Function to retrieve a solution, and mark it as most recently used
+bool LambertSolutionCache::retrieveSolution( const LambertArcKey& key, Eigen::Vector3d& departureVelocity,
+                                             Eigen::Vector3d& arrivalVelocity )
+{
+    auto solutionIterator = solutionsByKey_.find( key );
+    if( solutionIterator == solutionsByKey_.end( ) )
+    {
+        numberOfMisses_++;
+        return false;
+    }
+
+    numberOfHits_++;
+    solutions_.splice( solutions_.begin( ), solutions_, solutionIterator->second );
+    departureVelocity = solutionIterator->second->second.first;
+    arrivalVelocity = solutionIterator->second->second.second;
+    return true;
+}
+
+//! Function to add a solution (which must not be in the cache yet) as most recently used
+void LambertSolutionCache::addSolution( const LambertArcKey& key, const Eigen::Vector3d& departureVelocity,
+                                        const Eigen::Vector3d& arrivalVelocity )
+{
+    if( maximumNumberOfSolutions_ == 0 )
+    {
+        return;
+    }
+
+    if( solutions_.size( ) >= maximumNumberOfSolutions_ )
+    {
+        solutionsByKey_.erase( solutions_.back( ).first );
+        solutions_.pop_back( );
+    }
+    solutions_.push_front( std::make_pair( key, std::make_pair( departureVelocity, arrivalVelocity ) ) );
+    solutionsByKey_[ key ] = solutions_.begin( );
+}
+
+//! Function to retrieve the Lambert solution cache of the current thread, for a given maximum number of solutions
+LambertSolutionCache& getThreadLocalLambertSolutionCache( const std::size_t maximumNumberOfSolutions )
+{
+    thread_local std::map< std::size_t, LambertSolutionCache > lambertSolutionCaches;
+
+    auto cacheIterator = lambertSolutionCaches.find( maximumNumberOfSolutions );
+    if( cacheIterator == lambertSolutionCaches.end( ) )
+    {
+        // Cache is constructed in place, since its index refers to the elements of its list of solutions
+        cacheIterator = lambertSolutionCaches.emplace( std::piecewise_construct,
+                                                       std::forward_as_tuple( maximumNumberOfSolutions ),
+                                                       std::forward_as_tuple( maximumNumberOfSolutions ) ).first;
+    }
+    return cacheIterator->second;
+}
+
+//! Function to (re)allocate buffers for a given number of legs
+void MgaTrajectoryWorkspace::resize( const int numberOfLegs )
+{
+    if( numberOfLegs != numberOfLegs_ )
+    {
+        numberOfLegs_ = numberOfLegs;
+        buffers_.resize( numberOfLegs );
+    }
+}
+
+//! Function to compute the total Delta V of the trajectory
+double MgaTrajectoryWorkspace::computeDeltaV( const std::vector< double >& trajectoryVariables,
+                                              const std::vector< tudat::ephemerides::EphemerisPointer >& ephemerisVector,
+                                              const Eigen::VectorXd& gravitationalParameterVector,
+                                              const Eigen::VectorXd& minimumPericenterRadii,
+                                              const Eigen::VectorXd& semiMajorAxes,
+                                              const Eigen::VectorXd& eccentricities,
+                                              const double centralBodyGravitationalParameter,
+                                              const std::vector< int >& bodyIdentifiers,
+                                              const double epochResolution,
+                                              LambertSolutionCache* lambertSolutionCache )
+{
+    const bool useLambertSolutionCache = ( epochResolution > 0.0 );
+    if( useLambertSolutionCache && static_cast< int >( bodyIdentifiers.size( ) ) != numberOfLegs_ )
+    {
+        throw std::runtime_error( "Error when computing MGA Delta V, body identifiers are required for Lambert arc cache." );
+    }
+    if( useLambertSolutionCache && lambertSolutionCache == nullptr )
+    {
+        throw std::runtime_error( "Error when computing MGA Delta V, no cache provided for Lambert arcs." );
+    }
+
+    return computeMgaTrajectoryDeltaV(
+                buffers_, trajectoryVariables, ephemerisVector, gravitationalParameterVector, minimumPericenterRadii,
+                semiMajorAxes( 0 ), eccentricities( 0 ), semiMajorAxes( 1 ), eccentricities( 1 ),
+                centralBodyGravitationalParameter, bodyIdentifiers,
+                useLambertSolutionCache ? lambertSolutionCache : nullptr, epochResolution );
+}
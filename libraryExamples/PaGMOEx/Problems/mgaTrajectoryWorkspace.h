@@ -0,0 +1,390 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_MGA_TRAJECTORY_WORKSPACE_H
+#define TUDAT_EXAMPLE_PAGMO_MGA_TRAJECTORY_WORKSPACE_H
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <Tudat/Astrodynamics/BasicAstrodynamics/physicalConstants.h>
+#include <Tudat/Astrodynamics/Ephemerides/ephemeris.h>
+#include <Tudat/Astrodynamics/MissionSegments/escapeAndDeparture.h>
+#include <Tudat/Astrodynamics/MissionSegments/gravityAssist.h>
+#include <Tudat/Astrodynamics/MissionSegments/lambertRoutines.h>
+
+//! Gravitational parameter of the Sun, as used by the MGA transfer problems
+constexpr double getMgaSunGravitationalParameter( )
+{
+    return 1.32712428e20;
+}
+
+//! Semi-major axis and eccentricity of the departure orbit (escape from the sphere of influence) of the MGA transfer problems
+constexpr double getMgaDepartureSemiMajorAxis( )
+{
+    return std::numeric_limits< double >::infinity( );
+}
+
+constexpr double getMgaDepartureEccentricity( )
+{
+    return 0.0;
+}
+
+//! Semi-major axis and eccentricity of the capture orbit of the MGA transfer problems
+constexpr double getMgaCaptureSemiMajorAxis( )
+{
+    return 1.0895e8 / 0.02;
+}
+
+constexpr double getMgaCaptureEccentricity( )
+{
+    return 0.98;
+}
+
+//! Identifier of a Lambert arc, with departure and arrival epochs discretized to a given resolution
+struct LambertArcKey
+{
+    //! Identifiers of departure and arrival bodies (e.g. index in flyby sequence numbering)
+    int departureBody_;
+
+    int arrivalBody_;
+
+    //! Departure and arrival epochs, as integer multiples of the epoch resolution
+    std::int64_t departureEpochIndex_;
+
+    std::int64_t arrivalEpochIndex_;
+
+    //! Resolution (in days) to which the epochs are discretized
+    double epochResolution_;
+
+    //! Gravitational parameter of central body
+    double centralBodyGravitationalParameter_;
+
+    bool operator==( const LambertArcKey& otherKey ) const
+    {
+        return departureBody_ == otherKey.departureBody_ && arrivalBody_ == otherKey.arrivalBody_ &&
+                departureEpochIndex_ == otherKey.departureEpochIndex_ &&
+                arrivalEpochIndex_ == otherKey.arrivalEpochIndex_ && epochResolution_ == otherKey.epochResolution_ &&
+                centralBodyGravitationalParameter_ == otherKey.centralBodyGravitationalParameter_;
+    }
+};
+
+//! Hash function for LambertArcKey
+struct LambertArcKeyHash
+{
+    std::size_t operator( )( const LambertArcKey& key ) const
+    {
+        std::size_t hash = std::hash< std::int64_t >( )( key.departureEpochIndex_ );
+        hash = hash * 31 + std::hash< std::int64_t >( )( key.arrivalEpochIndex_ );
+        hash = hash * 31 + std::hash< int >( )( key.departureBody_ );
+        hash = hash * 31 + std::hash< int >( )( key.arrivalBody_ );
+        hash = hash * 31 + std::hash< double >( )( key.epochResolution_ );
+        return hash * 31 + std::hash< double >( )( key.centralBodyGravitationalParameter_ );
+    }
+};
+
+//! Cache of Lambert arc solutions, of which the least recently used solution is discarded when the cache is full.
+/*!
+ *  Cache of Lambert arc solutions (departure and arrival velocity), of which the least recently used solution is discarded
+ *  when the cache is full. The cache is not thread-safe; it is owned by a (per-thread) MgaTrajectoryWorkspace.
+ */
+class LambertSolutionCache
+{
+public:
+
+    //! Constructor
+    LambertSolutionCache( const std::size_t maximumNumberOfSolutions = 100000 ):
+        maximumNumberOfSolutions_( maximumNumberOfSolutions ), numberOfHits_( 0 ), numberOfMisses_( 0 ){ }
+
+    //! Function to set the maximum number of solutions, discarding the least recently used solutions if required
+    void setMaximumNumberOfSolutions( const std::size_t maximumNumberOfSolutions );
+
+    //! Function to retrieve a solution, and mark it as most recently used
+    /*!
+     *  Function to retrieve a solution, and mark it as most recently used
+     *  \param key Identifier of Lambert arc
+     *  \param departureVelocity Velocity at start of arc (returned by reference, if solution is found)
+     *  \param arrivalVelocity Velocity at end of arc (returned by reference, if solution is found)
+     *  \return True if the solution was found in the cache
+     */
+    bool retrieveSolution( const LambertArcKey& key, Eigen::Vector3d& departureVelocity, Eigen::Vector3d& arrivalVelocity );
+
+    //! Function to add a solution (which must not be in the cache yet) as most recently used
+    void addSolution( const LambertArcKey& key, const Eigen::Vector3d& departureVelocity,
+                      const Eigen::Vector3d& arrivalVelocity );
+
+    std::size_t getNumberOfSolutions( ) const
+    {
+        return solutionsByKey_.size( );
+    }
+
+    unsigned long long getNumberOfHits( ) const
+    {
+        return numberOfHits_;
+    }
+
+    unsigned long long getNumberOfMisses( ) const
+    {
+        return numberOfMisses_;
+    }
+
+private:
+
+    typedef std::pair< LambertArcKey, std::pair< Eigen::Vector3d, Eigen::Vector3d > > CachedSolution;
+
+    std::size_t maximumNumberOfSolutions_;
+
+    //! Cached solutions, most recently used first
+    std::list< CachedSolution > solutions_;
+
+    //! Position of each cached solution in solutions_
+    std::unordered_map< LambertArcKey, std::list< CachedSolution >::iterator, LambertArcKeyHash > solutionsByKey_;
+
+    unsigned long long numberOfHits_;
+
+    unsigned long long numberOfMisses_;
+};
+
+//! Function to retrieve the Lambert solution cache of the current thread, for a given maximum number of solutions.
+/*!
+ *  Function to retrieve the Lambert solution cache of the current thread, for a given maximum number of solutions. Each
+ *  thread creates one cache per maximum number of solutions, which is set once when the cache is created, so that problems
+ *  with different limits that are evaluated on the same thread do not resize (and evict) each other's cache. Since the
+ *  cached arcs are identified by their bodies, epochs, epoch resolution and central body, the cache is shared by all
+ *  problems with the same limit.
+ *  \param maximumNumberOfSolutions Maximum number of solutions in the cache
+ *  \return Lambert solution cache of the current thread
+ */
+LambertSolutionCache& getThreadLocalLambertSolutionCache( const std::size_t maximumNumberOfSolutions );
+
+//! Buffers for the intermediate results of the evaluation of an MGA trajectory.
+/*!
+ *  Buffers for the intermediate results of the evaluation of an MGA trajectory (see computeMgaTrajectoryDeltaV), with a
+ *  number of legs (departure, swingby and capture bodies) that is fixed at compile time, or Eigen::Dynamic.
+ */
+template< int NumberOfLegs >
+struct MgaTrajectoryBuffers
+{
+    static constexpr int NumberOfArcs = ( NumberOfLegs == Eigen::Dynamic ) ? Eigen::Dynamic : NumberOfLegs - 1;
+
+    //! Function to (re)allocate the buffers for a given number of legs (only for a dynamic number of legs)
+    void resize( const int numberOfLegs )
+    {
+        nodeEpochs_.resize( numberOfLegs );
+        nodeEpochIndices_.resize( numberOfLegs );
+        bodyStates_.resize( 6, numberOfLegs );
+        arcDepartureVelocities_.resize( 3, numberOfLegs - 1 );
+        arcArrivalVelocities_.resize( 3, numberOfLegs - 1 );
+    }
+
+    //! Epochs (in seconds since J2000) at which the departure, swingby and capture bodies are visited
+    Eigen::Matrix< double, NumberOfLegs, 1 > nodeEpochs_;
+
+    //! Node epochs as integer multiples of the epoch resolution (only used if Lambert arcs are cached)
+    Eigen::Matrix< std::int64_t, NumberOfLegs, 1 > nodeEpochIndices_;
+
+    //! Cartesian states of departure, swingby and capture bodies at node epochs (one column per body)
+    Eigen::Matrix< double, 6, NumberOfLegs > bodyStates_;
+
+    //! Velocities at start of each Lambert arc (one column per arc)
+    Eigen::Matrix< double, 3, NumberOfArcs > arcDepartureVelocities_;
+
+    //! Velocities at end of each Lambert arc (one column per arc)
+    Eigen::Matrix< double, 3, NumberOfArcs > arcArrivalVelocities_;
+};
+
+template< int NumberOfLegs >
+constexpr int MgaTrajectoryBuffers< NumberOfLegs >::NumberOfArcs;
+
+//! Function to compute the total Delta V of an MGA trajectory, using a given set of buffers.
+/*!
+ *  Function to compute the total Delta V of an MGA trajectory, consisting of a departure leg, any number of (powered)
+ *  swingby legs and a capture, in the same manner as the Tudat transfer_trajectories::Trajectory class (with mga_Departure,
+ *  mga_Swingby and capture legs). All intermediate results are stored in the buffers, which must be sized to the number
+ *  of legs. For a number of legs that is fixed at compile time, all loops over the legs have a constant trip count.
+ *
+ *  Optionally, the Lambert arc solutions are memoized in a LambertSolutionCache, so that they are reused for later
+ *  trajectories that visit the same bodies at the same epochs (e.g. other individuals of a converged population). To make
+ *  such trajectories identical, the epochs at which the bodies are visited are then rounded to a given resolution.
+ *  \param buffers Buffers for intermediate results, sized to the number of legs
+ *  \param trajectoryVariables Departure epoch and times of flight of all Lambert arcs (in days)
+ *  \param ephemerides Ephemerides of departure, swingby and capture bodies (indexable container of pointers)
+ *  \param gravitationalParameters Gravitational parameters of departure, swingby and capture bodies
+ *  \param minimumPericenterRadii Minimum pericenter radii of swingby bodies
+ *  \param departureSemiMajorAxis Semi-major axis of departure orbit
+ *  \param departureEccentricity Eccentricity of departure orbit
+ *  \param captureSemiMajorAxis Semi-major axis of capture orbit
+ *  \param captureEccentricity Eccentricity of capture orbit
+ *  \param centralBodyGravitationalParameter Gravitational parameter of central body of transfer
+ *  \param bodyIdentifiers Identifiers of departure, swingby and capture bodies, used to identify cached Lambert arcs
+ *  \param lambertSolutionCache Cache of Lambert arc solutions (nullptr if Lambert arcs are not memoized)
+ *  \param epochResolution Resolution (in days) to which the epochs at the bodies are rounded, for the memoization of
+ *  Lambert arcs (0 if epochs are not rounded and Lambert arcs are not memoized)
+ *  \return Total Delta V of trajectory
+ */
+template< int NumberOfLegs, typename EphemerisContainer, typename GravitationalParameterContainer,
+          typename PericenterRadiusContainer, typename BodyIdentifierContainer >
+double computeMgaTrajectoryDeltaV( MgaTrajectoryBuffers< NumberOfLegs >& buffers,
+                                   const std::vector< double >& trajectoryVariables,
+                                   const EphemerisContainer& ephemerides,
+                                   const GravitationalParameterContainer& gravitationalParameters,
+                                   const PericenterRadiusContainer& minimumPericenterRadii,
+                                   const double departureSemiMajorAxis,
+                                   const double departureEccentricity,
+                                   const double captureSemiMajorAxis,
+                                   const double captureEccentricity,
+                                   const double centralBodyGravitationalParameter,
+                                   const BodyIdentifierContainer& bodyIdentifiers,
+                                   LambertSolutionCache* lambertSolutionCache,
+                                   const double epochResolution )
+{
+    using namespace tudat::mission_segments;
+
+    const int numberOfLegs = static_cast< int >( buffers.nodeEpochs_.rows( ) );
+    const bool useLambertSolutionCache = ( epochResolution > 0.0 ) && ( lambertSolutionCache != nullptr );
+
+    // Compute epochs (in days, rounded to the resolution if arcs are cached) and states at which departure, swingby and
+    // capture bodies are visited
+    double nodeEpochInDays = 0.0;
+    for( int i = 0; i < numberOfLegs; i++ )
+    {
+        nodeEpochInDays += trajectoryVariables[ i ];
+        if( useLambertSolutionCache )
+        {
+            buffers.nodeEpochIndices_( i ) = static_cast< std::int64_t >( std::llround( nodeEpochInDays / epochResolution ) );
+            buffers.nodeEpochs_( i ) = static_cast< double >( buffers.nodeEpochIndices_( i ) ) * epochResolution *
+                    tudat::physical_constants::JULIAN_DAY;
+        }
+        else
+        {
+            buffers.nodeEpochs_( i ) = trajectoryVariables[ i ] * tudat::physical_constants::JULIAN_DAY;
+            if( i > 0 )
+            {
+                buffers.nodeEpochs_( i ) += buffers.nodeEpochs_( i - 1 );
+            }
+        }
+        buffers.bodyStates_.col( i ) = ephemerides[ i ]->getCartesianState( buffers.nodeEpochs_( i ) );
+    }
+
+    // Solve Lambert problem for each arc (if not in cache)
+    Eigen::Vector3d departureVelocity, arrivalVelocity;
+    LambertArcKey arcKey;
+    for( int i = 0; i < numberOfLegs - 1; i++ )
+    {
+        if( useLambertSolutionCache )
+        {
+            arcKey.departureBody_ = bodyIdentifiers[ i ];
+            arcKey.arrivalBody_ = bodyIdentifiers[ i + 1 ];
+            arcKey.departureEpochIndex_ = buffers.nodeEpochIndices_( i );
+            arcKey.arrivalEpochIndex_ = buffers.nodeEpochIndices_( i + 1 );
+            arcKey.epochResolution_ = epochResolution;
+            arcKey.centralBodyGravitationalParameter_ = centralBodyGravitationalParameter;
+        }
+
+        if( !useLambertSolutionCache ||
+                !lambertSolutionCache->retrieveSolution( arcKey, departureVelocity, arrivalVelocity ) )
+        {
+            solveLambertProblemIzzo( buffers.bodyStates_.template block< 3, 1 >( 0, i ),
+                                     buffers.bodyStates_.template block< 3, 1 >( 0, i + 1 ),
+                                     buffers.nodeEpochs_( i + 1 ) - buffers.nodeEpochs_( i ),
+                                     centralBodyGravitationalParameter, departureVelocity, arrivalVelocity );
+            if( useLambertSolutionCache )
+            {
+                lambertSolutionCache->addSolution( arcKey, departureVelocity, arrivalVelocity );
+            }
+        }
+        buffers.arcDepartureVelocities_.col( i ) = departureVelocity;
+        buffers.arcArrivalVelocities_.col( i ) = arrivalVelocity;
+    }
+
+    // Compute departure Delta V
+    double totalDeltaV = computeEscapeOrCaptureDeltaV(
+                gravitationalParameters[ 0 ], departureSemiMajorAxis, departureEccentricity,
+                ( buffers.arcDepartureVelocities_.col( 0 ) - buffers.bodyStates_.template block< 3, 1 >( 3, 0 ) ).norm( ) );
+
+    // Compute Delta V of all (powered) swingbys
+    for( int i = 1; i < numberOfLegs - 1; i++ )
+    {
+        totalDeltaV += calculateGravityAssistDeltaV(
+                    gravitationalParameters[ i ], buffers.bodyStates_.template block< 3, 1 >( 3, i ),
+                    buffers.arcArrivalVelocities_.col( i - 1 ), buffers.arcDepartureVelocities_.col( i ),
+                    minimumPericenterRadii[ i ] );
+    }
+
+    // Compute capture Delta V
+    totalDeltaV += computeEscapeOrCaptureDeltaV(
+                gravitationalParameters[ numberOfLegs - 1 ], captureSemiMajorAxis, captureEccentricity,
+                ( buffers.arcArrivalVelocities_.col( numberOfLegs - 2 ) -
+                  buffers.bodyStates_.template block< 3, 1 >( 3, numberOfLegs - 1 ) ).norm( ) );
+
+    return totalDeltaV;
+}
+
+//! Preallocated workspace for the evaluation of multiple gravity assist (MGA) trajectories.
+/*!
+ *  Preallocated workspace for the evaluation of multiple gravity assist (MGA) trajectories with any number of legs. The
+ *  Delta V is computed by computeMgaTrajectoryDeltaV, with buffers that are allocated once, and reused for each new set of
+ *  trajectory variables, and (optionally) a LambertSolutionCache. A workspace is not thread-safe, so each thread should
+ *  use its own workspace.
+ */
+class MgaTrajectoryWorkspace
+{
+public:
+
+    //! Constructor
+    MgaTrajectoryWorkspace( ): numberOfLegs_( 0 ){ }
+
+    //! Function to (re)allocate buffers for a given number of legs (no allocation if number of legs is unchanged)
+    void resize( const int numberOfLegs );
+
+    //! Function to compute the total Delta V of the trajectory.
+    /*!
+     *  Function to compute the total Delta V of the trajectory, for a new set of trajectory variables.
+     *  \param trajectoryVariables Departure epoch and times of flight of all Lambert arcs (in days)
+     *  \param ephemerisVector Ephemerides of departure, swingby and capture bodies
+     *  \param gravitationalParameterVector Gravitational parameters of departure, swingby and capture bodies
+     *  \param minimumPericenterRadii Minimum pericenter radii of swingby bodies
+     *  \param semiMajorAxes Semi-major axes of departure and capture orbits
+     *  \param eccentricities Eccentricities of departure and capture orbits
+     *  \param centralBodyGravitationalParameter Gravitational parameter of central body of transfer
+     *  \param bodyIdentifiers Identifiers of departure, swingby and capture bodies, used to identify cached Lambert arcs
+     *  \param epochResolution Resolution (in days) to which the epochs at the bodies are rounded, for the memoization of
+     *  Lambert arcs (0 if epochs are not rounded and Lambert arcs are not memoized)
+     *  \param lambertSolutionCache Cache of Lambert arc solutions (required if an epoch resolution is provided)
+     *  \return Total Delta V of trajectory
+     */
+    double computeDeltaV( const std::vector< double >& trajectoryVariables,
+                          const std::vector< tudat::ephemerides::EphemerisPointer >& ephemerisVector,
+                          const Eigen::VectorXd& gravitationalParameterVector,
+                          const Eigen::VectorXd& minimumPericenterRadii,
+                          const Eigen::VectorXd& semiMajorAxes,
+                          const Eigen::VectorXd& eccentricities,
+                          const double centralBodyGravitationalParameter,
+                          const std::vector< int >& bodyIdentifiers = std::vector< int >( ),
+                          const double epochResolution = 0.0,
+                          LambertSolutionCache* lambertSolutionCache = nullptr );
+
+private:
+
+    int numberOfLegs_;
+
+    //! Buffers for intermediate results
+    MgaTrajectoryBuffers< Eigen::Dynamic > buffers_;
+};
+
+#endif // TUDAT_EXAMPLE_PAGMO_MGA_TRAJECTORY_WORKSPACE_H
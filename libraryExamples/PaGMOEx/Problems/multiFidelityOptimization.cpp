@@ -0,0 +1,268 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "archipelagoDriver.h"
+#include "gridSearch.h"
+#include "multiFidelityOptimization.h"
+
+//! Constructor, fits the model to the differences at the sample points
+FidelityCorrectionModel::FidelityCorrectionModel(
+        const std::pair< pagmo::vector_double, pagmo::vector_double >& bounds,
+        const std::vector< pagmo::vector_double >& sampleDecisionVectors,
+        const std::vector< double >& fitnessDifferences ):
+    constantCorrection_( 0.0 )
+{
+    if( sampleDecisionVectors.size( ) != fitnessDifferences.size( ) )
+    {
+        throw std::runtime_error( "Error when creating fidelity correction model, inconsistent input sizes." );
+    }
+
+    if( !fitnessDifferences.empty( ) )
+    {
+        constantCorrection_ = std::accumulate( fitnessDifferences.begin( ), fitnessDifferences.end( ), 0.0 ) /
+                static_cast< double >( fitnessDifferences.size( ) );
+    }
+
+    if( sampleDecisionVectors.size( ) >= bounds.first.size( ) + 1 )
+    {
+        interpolationModel_ = std::make_shared< RadialBasisFunctionSurrogate >(
+                    bounds.first, bounds.second, sampleDecisionVectors, fitnessDifferences );
+    }
+}
+
+namespace
+{
+
+//! Function to evaluate the fitness of a set of decision vectors in parallel, using copies of the problem
+std::vector< pagmo::vector_double > evaluateFitnessInParallel(
+        const pagmo::problem& problem, const std::vector< pagmo::vector_double >& decisionVectors )
+{
+    unsigned int numberOfThreads = 0;
+    std::vector< pagmo::problem > problemCopies =
+            tudat_pagmo_applications::createThreadProblemCopies( problem, numberOfThreads );
+
+    std::vector< pagmo::vector_double > fitnessVectors( decisionVectors.size( ) );
+    tudat_pagmo_applications::executeTasksInParallel(
+                decisionVectors.size( ), [ & ]( const std::size_t taskIndex, const unsigned int threadIndex )
+    {
+        const pagmo::problem& threadProblem = problemCopies.empty( ) ? problem : problemCopies.at( threadIndex );
+        fitnessVectors.at( taskIndex ) = threadProblem.fitness( decisionVectors.at( taskIndex ) );
+    }, numberOfThreads );
+
+    return fitnessVectors;
+}
+
+//! Function to create an archipelago for a new stage, with the decision vectors of the islands of the previous stage as
+//! initial populations (evaluated in parallel for the new problem)
+pagmo::archipelago createStageArchipelago(
+        const pagmo::algorithm& algorithm, const pagmo::problem& problem, const pagmo::archipelago& previousArchipelago )
+{
+    std::vector< pagmo::vector_double > decisionVectors =
+            tudat_pagmo_applications::getArchipelagoDecisionVectors( previousArchipelago );
+    std::vector< pagmo::vector_double > fitnessVectors = evaluateFitnessInParallel( problem, decisionVectors );
+
+    pagmo::archipelago archipelago;
+    archipelago.set_topology( previousArchipelago.get_topology( ) );
+    std::size_t currentIndividual = 0;
+    for( const pagmo::island& previousIsland : previousArchipelago )
+    {
+        pagmo::population population( problem, 0 );
+        for( std::size_t i = 0; i < previousIsland.get_population( ).size( ); i++ )
+        {
+            population.push_back( decisionVectors.at( currentIndividual ), fitnessVectors.at( currentIndividual ) );
+            currentIndividual++;
+        }
+        archipelago.push_back( algorithm, population );
+    }
+    return archipelago;
+}
+
+//! Function to evolve an archipelago until its champion has converged, or the maximum number of evolutions is reached
+unsigned int evolveArchipelagoUntilConverged(
+        pagmo::archipelago& archipelago, const unsigned int maximumNumberOfEvolutions, const MultiFidelitySettings& settings,
+        const MultiFidelityStage stage, const MultiFidelityOutputFunction& outputFunction )
+{
+    if( outputFunction )
+    {
+        outputFunction( archipelago, 0, stage );
+    }
+
+    double previousChampionFitness = tudat_pagmo_applications::getArchipelagoChampion( archipelago ).second.at( 0 );
+    unsigned int numberOfStalledEvolutions = 0;
+    unsigned int numberOfEvolutions = 0;
+    while( numberOfEvolutions < maximumNumberOfEvolutions &&
+           numberOfStalledEvolutions < settings.numberOfStallEvolutions_ )
+    {
+        tudat_pagmo_applications::evolveArchipelago( archipelago, 1 );
+        numberOfEvolutions++;
+
+        const double championFitness = tudat_pagmo_applications::getArchipelagoChampion( archipelago ).second.at( 0 );
+        const double improvementTolerance = std::max(
+                    settings.relativeConvergenceTolerance_ * std::fabs( previousChampionFitness ),
+                    settings.absoluteConvergenceTolerance_ );
+        if( !( previousChampionFitness - championFitness > improvementTolerance ) )
+        {
+            numberOfStalledEvolutions++;
+        }
+        else
+        {
+            numberOfStalledEvolutions = 0;
+        }
+        previousChampionFitness = std::min( previousChampionFitness, championFitness );
+
+        if( outputFunction )
+        {
+            outputFunction( archipelago, numberOfEvolutions, stage );
+        }
+    }
+    return numberOfEvolutions;
+}
+
+}
+
+//! Function to perform a single-objective optimization with a low- and high-fidelity model of the fitness function.
+MultiFidelityResults performMultiFidelityOptimization(
+        const pagmo::algorithm& algorithm,
+        const pagmo::problem& lowFidelityProblem,
+        const pagmo::problem& highFidelityProblem,
+        const unsigned int numberOfIslands,
+        const pagmo::population::size_type populationSizePerIsland,
+        const MultiFidelitySettings& settings,
+        const MultiFidelityOutputFunction outputFunction,
+        const MultiFidelityStageStartFunction stageStartFunction )
+{
+    if( lowFidelityProblem.get_nobj( ) != 1 || highFidelityProblem.get_nobj( ) != 1 ||
+            lowFidelityProblem.get_nc( ) != 0 || highFidelityProblem.get_nc( ) != 0 )
+    {
+        throw std::runtime_error( "Error, multi-fidelity optimization requires unconstrained single-objective problems." );
+    }
+    if( lowFidelityProblem.get_bounds( ) != highFidelityProblem.get_bounds( ) )
+    {
+        throw std::runtime_error( "Error, multi-fidelity optimization requires problems with identical bounds." );
+    }
+
+    MultiFidelityResults results;
+    results.numberOfEvolutions_.resize( 4, 0 );
+    results.numberOfHighFidelityEvaluations_.resize( 4, 0 );
+
+    // Evolve on low-fidelity problem until converged
+    if( stageStartFunction )
+    {
+        stageStartFunction( low_fidelity_stage );
+    }
+    results.lowFidelityArchipelago_ = tudat_pagmo_applications::createArchipelago(
+                algorithm, lowFidelityProblem, numberOfIslands, populationSizePerIsland );
+    results.numberOfEvolutions_.at( low_fidelity_stage ) = evolveArchipelagoUntilConverged(
+                results.lowFidelityArchipelago_, settings.maximumNumberOfLowFidelityEvolutions_, settings,
+                low_fidelity_stage, outputFunction );
+
+    // Evaluate high-fidelity fitness for best (distinct) low-fidelity individuals, and fit correction model
+    if( stageStartFunction )
+    {
+        stageStartFunction( correction_sampling_stage );
+    }
+    {
+        const std::vector< pagmo::vector_double > decisionVectors =
+                tudat_pagmo_applications::getArchipelagoDecisionVectors( results.lowFidelityArchipelago_ );
+        const std::vector< pagmo::vector_double > fitnessVectors =
+                tudat_pagmo_applications::getArchipelagoFitnessVectors( results.lowFidelityArchipelago_ );
+
+        std::vector< std::size_t > sortedIndices( decisionVectors.size( ) );
+        std::iota( sortedIndices.begin( ), sortedIndices.end( ), 0 );
+        std::stable_sort( sortedIndices.begin( ), sortedIndices.end( ), [ & ]( const std::size_t i, const std::size_t j )
+        {
+            return fitnessVectors.at( i ).at( 0 ) < fitnessVectors.at( j ).at( 0 );
+        } );
+
+        std::vector< pagmo::vector_double > sampleDecisionVectors;
+        for( unsigned int i = 0; i < sortedIndices.size( ) &&
+             sampleDecisionVectors.size( ) < settings.numberOfCorrectionSamples_; i++ )
+        {
+            const pagmo::vector_double& candidate = decisionVectors.at( sortedIndices.at( i ) );
+            if( std::find( sampleDecisionVectors.begin( ), sampleDecisionVectors.end( ), candidate ) ==
+                    sampleDecisionVectors.end( ) )
+            {
+                sampleDecisionVectors.push_back( candidate );
+            }
+        }
+
+        const std::vector< pagmo::vector_double > lowFidelityFitness =
+                evaluateFitnessInParallel( lowFidelityProblem, sampleDecisionVectors );
+        const std::vector< pagmo::vector_double > highFidelityFitness =
+                evaluateFitnessInParallel( highFidelityProblem, sampleDecisionVectors );
+        results.numberOfHighFidelityEvaluations_.at( correction_sampling_stage ) = sampleDecisionVectors.size( );
+
+        std::vector< pagmo::vector_double > correctionDecisionVectors;
+        std::vector< double > fitnessDifferences;
+        for( unsigned int i = 0; i < sampleDecisionVectors.size( ); i++ )
+        {
+            const double fitnessDifference = highFidelityFitness.at( i ).at( 0 ) - lowFidelityFitness.at( i ).at( 0 );
+            if( std::isfinite( fitnessDifference ) )
+            {
+                correctionDecisionVectors.push_back( sampleDecisionVectors.at( i ) );
+                fitnessDifferences.push_back( fitnessDifference );
+            }
+        }
+        results.correctionModel_ = FidelityCorrectionModel(
+                    lowFidelityProblem.get_bounds( ), correctionDecisionVectors, fitnessDifferences );
+    }
+
+    // Evolve on corrected low-fidelity problem until converged
+    if( stageStartFunction )
+    {
+        stageStartFunction( corrected_low_fidelity_stage );
+    }
+    const pagmo::problem correctedProblem{ CorrectedLowFidelityProblem( lowFidelityProblem, results.correctionModel_ ) };
+    results.correctedArchipelago_ = createStageArchipelago( algorithm, correctedProblem, results.lowFidelityArchipelago_ );
+    results.numberOfEvolutions_.at( corrected_low_fidelity_stage ) = evolveArchipelagoUntilConverged(
+                results.correctedArchipelago_, settings.maximumNumberOfCorrectedEvolutions_, settings,
+                corrected_low_fidelity_stage, outputFunction );
+
+    // Evolve on high-fidelity problem until converged
+    if( stageStartFunction )
+    {
+        stageStartFunction( high_fidelity_stage );
+    }
+    pagmo::problem highFidelityStageProblem = highFidelityProblem;
+    if( settings.highFidelityPreScreeningSettings_ != nullptr )
+    {
+        highFidelityStageProblem = pagmo::problem{
+                SurrogateAssistedProblem( highFidelityProblem, *settings.highFidelityPreScreeningSettings_ ) };
+    }
+    results.highFidelityArchipelago_ = createStageArchipelago(
+                algorithm, highFidelityStageProblem, results.correctedArchipelago_ );
+    results.numberOfEvolutions_.at( high_fidelity_stage ) = evolveArchipelagoUntilConverged(
+                results.highFidelityArchipelago_, settings.maximumNumberOfHighFidelityEvolutions_, settings,
+                high_fidelity_stage, outputFunction );
+
+    if( settings.highFidelityPreScreeningSettings_ != nullptr )
+    {
+        // Evaluations are counted by the data shared by all copies of the surrogate-assisted problem
+        results.numberOfHighFidelityEvaluations_.at( high_fidelity_stage ) =
+                highFidelityStageProblem.extract< SurrogateAssistedProblem >( )->getNumberOfTrueEvaluations( );
+    }
+    else
+    {
+        results.numberOfHighFidelityEvaluations_.at( high_fidelity_stage ) =
+                tudat_pagmo_applications::getArchipelagoDecisionVectors( results.correctedArchipelago_ ).size( );
+        for( const pagmo::island& currentIsland : results.highFidelityArchipelago_ )
+        {
+            results.numberOfHighFidelityEvaluations_.at( high_fidelity_stage ) +=
+                    currentIsland.get_population( ).get_problem( ).get_fevals( );
+        }
+    }
+
+    return results;
+}
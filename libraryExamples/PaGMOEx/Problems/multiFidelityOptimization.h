@@ -0,0 +1,239 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_MULTI_FIDELITY_OPTIMIZATION_H
+#define TUDAT_EXAMPLE_PAGMO_MULTI_FIDELITY_OPTIMIZATION_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pagmo/algorithm.hpp>
+#include <pagmo/archipelago.hpp>
+#include <pagmo/problem.hpp>
+#include <pagmo/threading.hpp>
+#include <pagmo/types.hpp>
+
+#include "radialBasisFunctionSurrogate.h"
+#include "surrogateAssistedProblem.h"
+
+//! Model of the difference between the fitness of a high- and low-fidelity problem (single objective)
+/*!
+ *  Model of the difference between the fitness of a high- and low-fidelity problem (single objective), fitted to the
+ *  differences at a set of sample points. If there are sufficient samples (size of decision vector + 1), the difference is
+ *  interpolated with a radial basis function model (see RadialBasisFunctionSurrogate); otherwise, the mean difference is
+ *  used as a constant correction.
+ */
+class FidelityCorrectionModel
+{
+public:
+
+    //! Constructor, for zero correction
+    FidelityCorrectionModel( ): constantCorrection_( 0.0 ){ }
+
+    //! Constructor, fits the model to the differences at the sample points
+    /*!
+     *  Constructor, fits the model to the differences at the sample points
+     *  \param bounds Bounds of decision vector
+     *  \param sampleDecisionVectors Decision vectors of sample points
+     *  \param fitnessDifferences Difference between high- and low-fidelity fitness at sample points
+     */
+    FidelityCorrectionModel( const std::pair< pagmo::vector_double, pagmo::vector_double >& bounds,
+                             const std::vector< pagmo::vector_double >& sampleDecisionVectors,
+                             const std::vector< double >& fitnessDifferences );
+
+    //! Function to compute the correction (to be added to the low-fidelity fitness) at the given decision vector
+    double computeCorrection( const pagmo::vector_double& decisionVector ) const
+    {
+        return ( interpolationModel_ != nullptr ) ? interpolationModel_->predict( decisionVector ) : constantCorrection_;
+    }
+
+private:
+
+    //! Interpolation model of differences (nullptr if constant correction is used)
+    std::shared_ptr< const RadialBasisFunctionSurrogate > interpolationModel_;
+
+    double constantCorrection_;
+};
+
+//! Problem of which the fitness is that of a low-fidelity problem, corrected by a model of the difference w.r.t. a
+//! high-fidelity problem.
+struct CorrectedLowFidelityProblem
+{
+    //! Empty constructor
+    CorrectedLowFidelityProblem( ){ }
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param lowFidelityProblem Problem with low-fidelity (cheap) fitness function
+     *  \param correctionModel Model of the difference between high- and low-fidelity fitness
+     */
+    CorrectedLowFidelityProblem( const pagmo::problem& lowFidelityProblem,
+                                 const FidelityCorrectionModel& correctionModel ):
+        lowFidelityProblem_( lowFidelityProblem ), correctionModel_( correctionModel ){ }
+
+    //! Fitness, low-fidelity fitness plus correction
+    pagmo::vector_double fitness( const pagmo::vector_double& decisionVector ) const
+    {
+        pagmo::vector_double fitness = lowFidelityProblem_.fitness( decisionVector );
+        fitness.at( 0 ) += correctionModel_.computeCorrection( decisionVector );
+        return fitness;
+    }
+
+    //! Boundaries of the problem (identical to low-fidelity problem)
+    std::pair< pagmo::vector_double, pagmo::vector_double > get_bounds( ) const
+    {
+        return lowFidelityProblem_.get_bounds( );
+    }
+
+    std::string get_name( ) const
+    {
+        return "Corrected " + lowFidelityProblem_.get_name( );
+    }
+
+    pagmo::thread_safety get_thread_safety( ) const
+    {
+        return ( lowFidelityProblem_.get_thread_safety( ) == pagmo::thread_safety::none ) ?
+                    pagmo::thread_safety::none : pagmo::thread_safety::basic;
+    }
+
+private:
+
+    pagmo::problem lowFidelityProblem_;
+
+    FidelityCorrectionModel correctionModel_;
+};
+
+//! Stages of a multi-fidelity optimization (see performMultiFidelityOptimization)
+enum MultiFidelityStage
+{
+    low_fidelity_stage = 0,
+    correction_sampling_stage = 1,
+    corrected_low_fidelity_stage = 2,
+    high_fidelity_stage = 3
+};
+
+//! Settings for a multi-fidelity optimization
+struct MultiFidelitySettings
+{
+    MultiFidelitySettings( const unsigned int maximumNumberOfLowFidelityEvolutions = 50,
+                           const unsigned int maximumNumberOfCorrectedEvolutions = 25,
+                           const unsigned int maximumNumberOfHighFidelityEvolutions = 4,
+                           const unsigned int numberOfStallEvolutions = 5,
+                           const double relativeConvergenceTolerance = 1.0E-6,
+                           const double absoluteConvergenceTolerance = 1.0E-8,
+                           const unsigned int numberOfCorrectionSamples = 16,
+                           const std::shared_ptr< SurrogatePreScreeningSettings > highFidelityPreScreeningSettings = nullptr ):
+        maximumNumberOfLowFidelityEvolutions_( maximumNumberOfLowFidelityEvolutions ),
+        maximumNumberOfCorrectedEvolutions_( maximumNumberOfCorrectedEvolutions ),
+        maximumNumberOfHighFidelityEvolutions_( maximumNumberOfHighFidelityEvolutions ),
+        numberOfStallEvolutions_( numberOfStallEvolutions ),
+        relativeConvergenceTolerance_( relativeConvergenceTolerance ),
+        absoluteConvergenceTolerance_( absoluteConvergenceTolerance ),
+        numberOfCorrectionSamples_( numberOfCorrectionSamples ),
+        highFidelityPreScreeningSettings_( highFidelityPreScreeningSettings ){ }
+
+    //! Maximum number of evolutions in the low-fidelity stage (fewer if converged)
+    unsigned int maximumNumberOfLowFidelityEvolutions_;
+
+    //! Maximum number of evolutions in the corrected low-fidelity stage (fewer if converged, 0 to skip stage)
+    unsigned int maximumNumberOfCorrectedEvolutions_;
+
+    //! Maximum number of evolutions in the high-fidelity stage (fewer if converged)
+    unsigned int maximumNumberOfHighFidelityEvolutions_;
+
+    //! Number of consecutive evolutions without significant improvement of the champion after which a stage is converged
+    unsigned int numberOfStallEvolutions_;
+
+    //! Relative improvement of the champion fitness below which an evolution is considered to have stalled
+    double relativeConvergenceTolerance_;
+
+    //! Absolute improvement of the champion fitness below which an evolution is considered to have stalled
+    double absoluteConvergenceTolerance_;
+
+    //! Number of (best) low-fidelity individuals at which the high-fidelity fitness is evaluated to fit the correction
+    unsigned int numberOfCorrectionSamples_;
+
+    //! Settings for surrogate pre-screening in the high-fidelity stage (none if nullptr)
+    std::shared_ptr< SurrogatePreScreeningSettings > highFidelityPreScreeningSettings_;
+};
+
+//! Function type for the output during a multi-fidelity optimization, called with the archipelago of the current stage, the
+//! number of evolutions performed in this stage (0 for the initial population of the stage), and the stage
+typedef std::function< void( const pagmo::archipelago& archipelago, const unsigned int numberOfEvolutions,
+                             const MultiFidelityStage stage ) > MultiFidelityOutputFunction;
+
+//! Function type that is called at the start of each stage of a multi-fidelity optimization (e.g. to modify problem settings)
+typedef std::function< void( const MultiFidelityStage stage ) > MultiFidelityStageStartFunction;
+
+//! Results of a multi-fidelity optimization
+struct MultiFidelityResults
+{
+    //! Archipelago at the end of the low-fidelity stage
+    pagmo::archipelago lowFidelityArchipelago_;
+
+    //! Archipelago at the end of the corrected low-fidelity stage
+    pagmo::archipelago correctedArchipelago_;
+
+    //! Archipelago at the end of the high-fidelity stage
+    pagmo::archipelago highFidelityArchipelago_;
+
+    //! Model of the difference between high- and low-fidelity fitness, fitted in the correction sampling stage
+    FidelityCorrectionModel correctionModel_;
+
+    //! Number of evolutions performed in each stage (zero for correction sampling stage)
+    std::vector< unsigned int > numberOfEvolutions_;
+
+    //! Number of high-fidelity fitness evaluations (excluding surrogate pre-screened evaluations) performed in each stage
+    std::vector< unsigned long long > numberOfHighFidelityEvaluations_;
+};
+
+//! Function to perform a single-objective optimization with a low- and high-fidelity model of the fitness function.
+/*!
+ *  Function to perform a single-objective optimization with a low- and high-fidelity model of the fitness function (e.g.
+ *  point-mass and perturbed dynamics), so that the expensive high-fidelity model is only used once the population has
+ *  converged to the relevant part of the search space. The optimization is performed on an archipelago of identical islands
+ *  (see createArchipelago), and consists of the following stages:
+ *
+ *  1. Low-fidelity stage: the archipelago is evolved on the low-fidelity problem until it converges (champion fitness has
+ *     not improved significantly for numberOfStallEvolutions_ evolutions) or the maximum number of evolutions is reached.
+ *  2. Correction sampling stage: the high-fidelity fitness is evaluated (in parallel) for the best low-fidelity individuals,
+ *     and a model of the difference between the fidelities is fitted (see FidelityCorrectionModel).
+ *  3. Corrected low-fidelity stage: the final populations of stage 1 are evolved on the low-fidelity problem plus
+ *     correction (a cheap approximation of the high-fidelity problem), until convergence.
+ *  4. High-fidelity stage: the final populations of stage 3 are re-evaluated with the high-fidelity problem (optionally
+ *     with surrogate pre-screening, see SurrogateAssistedProblem), and evolved until convergence.
+ *
+ *  The low-fidelity problem must return its exact fitness when the correction sampling stage starts (any early termination
+ *  of fitness evaluations may be disabled in the stage start function).
+ *  \param algorithm Algorithm used by each island
+ *  \param lowFidelityProblem Problem with low-fidelity (cheap) fitness function
+ *  \param highFidelityProblem Problem with high-fidelity (expensive) fitness function
+ *  \param numberOfIslands Number of islands in archipelago
+ *  \param populationSizePerIsland Number of individuals per island
+ *  \param settings Settings for the multi-fidelity optimization
+ *  \param outputFunction Function called for the initial population of each stage, and after each evolution (none if empty)
+ *  \param stageStartFunction Function called at the start of each stage (none if empty)
+ *  \return Results of the optimization
+ */
+MultiFidelityResults performMultiFidelityOptimization(
+        const pagmo::algorithm& algorithm,
+        const pagmo::problem& lowFidelityProblem,
+        const pagmo::problem& highFidelityProblem,
+        const unsigned int numberOfIslands,
+        const pagmo::population::size_type populationSizePerIsland,
+        const MultiFidelitySettings& settings = MultiFidelitySettings( ),
+        const MultiFidelityOutputFunction outputFunction = MultiFidelityOutputFunction( ),
+        const MultiFidelityStageStartFunction stageStartFunction = MultiFidelityStageStartFunction( ) );
+
+#endif // TUDAT_EXAMPLE_PAGMO_MULTI_FIDELITY_OPTIMIZATION_H
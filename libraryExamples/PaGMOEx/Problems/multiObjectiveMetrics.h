@@ -0,0 +1,402 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_MULTI_OBJECTIVE_METRICS_H
+#define TUDAT_PAGMO_MULTI_OBJECTIVE_METRICS_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/math/constants/constants.hpp>
+
+#include <pagmo/types.hpp>
+#include <pagmo/utils/hypervolume.hpp>
+#include <pagmo/utils/multi_objective.hpp>
+
+namespace tudat_pagmo_applications
+{
+
+//! Function to retrieve (a discretization of) the analytical Pareto front of a ZDT test problem.
+/*!
+ *  Function to retrieve (a discretization of) the analytical Pareto front of a ZDT test problem, for use as reference front
+ *  when computing the inverted generational distance. The front is sampled at equidistant values of the first objective,
+ *  and only the non-dominated samples are retained (for the disconnected front of ZDT3).
+ *  \param problemId Identifier of the ZDT problem (as in pagmo::zdt), ZDT5 (binary problem) is not supported
+ *  \param numberOfPoints Number of samples of the first objective
+ *  \return Points of Pareto front
+ */
+inline std::vector< pagmo::vector_double > getZdtParetoFront( const unsigned int problemId,
+                                                              const unsigned int numberOfPoints = 1000 )
+{
+    if( numberOfPoints < 2 )
+    {
+        throw std::runtime_error( "Error when retrieving ZDT Pareto front, at least two points are required." );
+    }
+
+    // Minimum value of first objective on front (ZDT6 front does not start at 0)
+    const double minimumFirstObjective = ( problemId == 6 ) ? 0.2807753191 : 0.0;
+
+    std::vector< pagmo::vector_double > paretoFront;
+    for( unsigned int i = 0; i < numberOfPoints; i++ )
+    {
+        const double firstObjective = minimumFirstObjective + ( 1.0 - minimumFirstObjective ) *
+                static_cast< double >( i ) / static_cast< double >( numberOfPoints - 1 );
+        double secondObjective;
+        switch( problemId )
+        {
+        case 1:
+        case 4:
+            secondObjective = 1.0 - std::sqrt( firstObjective );
+            break;
+        case 2:
+        case 6:
+            secondObjective = 1.0 - firstObjective * firstObjective;
+            break;
+        case 3:
+            secondObjective = 1.0 - std::sqrt( firstObjective ) - firstObjective *
+                    std::sin( 10.0 * boost::math::constants::pi< double >( ) * firstObjective );
+            break;
+        default:
+            throw std::runtime_error( "Error, Pareto front of ZDT problem " + std::to_string( problemId ) +
+                                      " is not available." );
+        }
+
+        // Discard points dominated by the previous point on the front (only occurs for ZDT3)
+        if( paretoFront.empty( ) || secondObjective < paretoFront.back( ).at( 1 ) )
+        {
+            paretoFront.push_back( { firstObjective, secondObjective } );
+        }
+    }
+    return paretoFront;
+}
+
+//! Function to compute the hypervolume of a set of points with respect to a reference point.
+/*!
+ *  Function to compute the hypervolume of a set of points with respect to a reference point (see pagmo::hypervolume). Points
+ *  that do not strictly dominate the reference point do not contribute to the hypervolume, and are ignored.
+ *  \param points Fitness vectors of points
+ *  \param referencePoint Reference point (should be dominated by the Pareto front)
+ *  \return Hypervolume (zero if no point dominates the reference point)
+ */
+inline double computeHypervolume( const std::vector< pagmo::vector_double >& points,
+                                  const pagmo::vector_double& referencePoint )
+{
+    std::vector< pagmo::vector_double > contributingPoints;
+    for( unsigned int i = 0; i < points.size( ); i++ )
+    {
+        bool isPointContributing = true;
+        for( unsigned int j = 0; j < referencePoint.size( ); j++ )
+        {
+            if( !( points.at( i ).at( j ) < referencePoint.at( j ) ) )
+            {
+                isPointContributing = false;
+            }
+        }
+        if( isPointContributing )
+        {
+            contributingPoints.push_back( points.at( i ) );
+        }
+    }
+
+    if( contributingPoints.empty( ) )
+    {
+        return 0.0;
+    }
+    return pagmo::hypervolume( contributingPoints, false ).compute( referencePoint );
+}
+
+//! Function to compute the number of non-dominated points in a set of (fitness) points
+inline unsigned int getNumberOfNonDominatedPoints( const std::vector< pagmo::vector_double >& points )
+{
+    if( points.size( ) < 2 )
+    {
+        return points.size( );
+    }
+    return std::get< 0 >( pagmo::fast_non_dominated_sorting( points ) ).at( 0 ).size( );
+}
+
+//! Archive of all non-dominated points found during an optimization, which is updated incrementally.
+/*!
+ *  Archive of all non-dominated points found during an optimization, which is updated incrementally: each new point is only
+ *  compared to the current archive (the front of all previously added points), rather than re-sorting all points found so
+ *  far. A point is added if it is not dominated by (or equal to) any archived point, in which case the archived points it
+ *  dominates are removed.
+ */
+class ParetoFrontArchive
+{
+public:
+
+    ParetoFrontArchive( ): hasRemovedPoints_( false ){ }
+
+    //! Function to add a set of points to the archive, returning the number of points that were added to the archive
+    /*!
+     *  Function to add a set of points to the archive, returning the number of points that were added to the archive. After
+     *  the update, hasRemovedPoints returns whether any previously archived point was removed during this update.
+     *  \param decisionVectors Decision vectors of points
+     *  \param fitnessVectors Fitness vectors of points
+     *  \return Number of points added to archive
+     */
+    unsigned int addPoints( const std::vector< pagmo::vector_double >& decisionVectors,
+                            const std::vector< pagmo::vector_double >& fitnessVectors )
+    {
+        if( decisionVectors.size( ) != fitnessVectors.size( ) )
+        {
+            throw std::runtime_error( "Error when adding points to Pareto front archive, inconsistent input sizes." );
+        }
+
+        hasRemovedPoints_ = false;
+        unsigned int numberOfAddedPoints = 0;
+        for( unsigned int i = 0; i < fitnessVectors.size( ); i++ )
+        {
+            // Check if point is dominated by (or identical to) archived point
+            bool isPointDominated = false;
+            for( unsigned int j = 0; j < fitnessVectors_.size( ) && !isPointDominated; j++ )
+            {
+                isPointDominated = pagmo::pareto_dominance( fitnessVectors_.at( j ), fitnessVectors.at( i ) ) ||
+                        fitnessVectors_.at( j ) == fitnessVectors.at( i );
+            }
+            if( isPointDominated )
+            {
+                continue;
+            }
+
+            // Remove archived points that are dominated by new point
+            unsigned int numberOfRetainedPoints = 0;
+            for( unsigned int j = 0; j < fitnessVectors_.size( ); j++ )
+            {
+                if( !pagmo::pareto_dominance( fitnessVectors.at( i ), fitnessVectors_.at( j ) ) )
+                {
+                    if( numberOfRetainedPoints != j )
+                    {
+                        fitnessVectors_.at( numberOfRetainedPoints ) = std::move( fitnessVectors_.at( j ) );
+                        decisionVectors_.at( numberOfRetainedPoints ) = std::move( decisionVectors_.at( j ) );
+                    }
+                    numberOfRetainedPoints++;
+                }
+            }
+            if( numberOfRetainedPoints != fitnessVectors_.size( ) )
+            {
+                hasRemovedPoints_ = true;
+                fitnessVectors_.resize( numberOfRetainedPoints );
+                decisionVectors_.resize( numberOfRetainedPoints );
+            }
+
+            fitnessVectors_.push_back( fitnessVectors.at( i ) );
+            decisionVectors_.push_back( decisionVectors.at( i ) );
+            numberOfAddedPoints++;
+        }
+        return numberOfAddedPoints;
+    }
+
+    //! Function to retrieve whether any archived point was removed during the last update
+    bool hasRemovedPoints( ) const
+    {
+        return hasRemovedPoints_;
+    }
+
+    //! Function to retrieve the decision vectors of the archived points
+    const std::vector< pagmo::vector_double >& getDecisionVectors( ) const
+    {
+        return decisionVectors_;
+    }
+
+    //! Function to retrieve the fitness vectors of the archived points
+    const std::vector< pagmo::vector_double >& getFitnessVectors( ) const
+    {
+        return fitnessVectors_;
+    }
+
+    //! Function to retrieve the number of archived points
+    std::size_t size( ) const
+    {
+        return fitnessVectors_.size( );
+    }
+
+private:
+
+    std::vector< pagmo::vector_double > decisionVectors_;
+
+    std::vector< pagmo::vector_double > fitnessVectors_;
+
+    //! Boolean denoting whether any archived point was removed during the last update
+    bool hasRemovedPoints_;
+};
+
+//! Convergence metrics of a multi-objective optimization at a single generation
+struct MultiObjectiveMetrics
+{
+    unsigned int generation_;
+
+    //! Number of non-dominated individuals in current population
+    unsigned int numberOfNonDominatedIndividuals_;
+
+    //! Number of points in archive of all non-dominated points found so far
+    unsigned int archiveSize_;
+
+    //! Hypervolume of archive
+    double hypervolume_;
+
+    //! Inverted generational distance of archive w.r.t. reference front (NaN if no reference front is provided)
+    double invertedGenerationalDistance_;
+};
+
+//! Class to compute and log convergence metrics of a multi-objective optimization, generation by generation.
+/*!
+ *  Class to compute and log convergence metrics of a multi-objective optimization, generation by generation, as an
+ *  alternative to storing the full population at each generation. For each generation, the population is added to a
+ *  ParetoFrontArchive, and the hypervolume and inverted generational distance (IGD, mean distance from each point of a
+ *  known reference front to the closest archived point) of the archive are computed, along with the number of non-dominated
+ *  individuals in the population. The metrics are updated incrementally: both are only recomputed if the archive changed,
+ *  and if points were only added to the archive, the IGD is updated using only the new points. The metrics are written to a
+ *  text file, one line per generation (generation, number of non-dominated individuals, archive size, hypervolume, IGD).
+ */
+class MultiObjectiveMetricsLogger
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param filePath Path of metrics file (directories are created if needed)
+     *  \param hypervolumeReferencePoint Reference point for hypervolume computation
+     *  \param referenceFront Points of known Pareto front, for computation of IGD (none if empty)
+     */
+    MultiObjectiveMetricsLogger( const std::string& filePath,
+                                 const pagmo::vector_double& hypervolumeReferencePoint,
+                                 const std::vector< pagmo::vector_double >& referenceFront =
+            std::vector< pagmo::vector_double >( ) ):
+        filePath_( filePath ), hypervolumeReferencePoint_( hypervolumeReferencePoint ), referenceFront_( referenceFront ),
+        closestArchiveDistances_( referenceFront.size( ), std::numeric_limits< double >::infinity( ) ),
+        hypervolume_( 0.0 ), invertedGenerationalDistance_( std::numeric_limits< double >::quiet_NaN( ) )
+    {
+        const boost::filesystem::path parentPath = boost::filesystem::path( filePath ).parent_path( );
+        if( !parentPath.empty( ) )
+        {
+            boost::filesystem::create_directories( parentPath );
+        }
+
+        fileStream_.open( filePath );
+        if( !fileStream_ )
+        {
+            throw std::runtime_error( "Error when creating multi-objective metrics file " + filePath );
+        }
+        fileStream_ << std::setprecision( 16 );
+    }
+
+    //! Function to update the metrics with the population of a new generation, and write them to the file
+    /*!
+     *  Function to update the metrics with the population of a new generation, and write them to the file
+     *  \param generation Generation number
+     *  \param decisionVectors Decision vectors of population
+     *  \param fitnessVectors Fitness vectors of population
+     *  \return Metrics at current generation
+     */
+    MultiObjectiveMetrics addGeneration( const unsigned int generation,
+                                         const std::vector< pagmo::vector_double >& decisionVectors,
+                                         const std::vector< pagmo::vector_double >& fitnessVectors )
+    {
+        const std::size_t previousArchiveSize = archive_.size( );
+        const unsigned int numberOfAddedPoints = archive_.addPoints( decisionVectors, fitnessVectors );
+
+        if( numberOfAddedPoints > 0 )
+        {
+            hypervolume_ = computeHypervolume( archive_.getFitnessVectors( ), hypervolumeReferencePoint_ );
+            if( !referenceFront_.empty( ) )
+            {
+                // New points are at the end of the archive; all points must be checked if any point was removed.
+                updateInvertedGenerationalDistance(
+                            archive_.hasRemovedPoints( ) ? 0 : previousArchiveSize, archive_.hasRemovedPoints( ) );
+            }
+        }
+
+        MultiObjectiveMetrics metrics;
+        metrics.generation_ = generation;
+        metrics.numberOfNonDominatedIndividuals_ = getNumberOfNonDominatedPoints( fitnessVectors );
+        metrics.archiveSize_ = archive_.size( );
+        metrics.hypervolume_ = hypervolume_;
+        metrics.invertedGenerationalDistance_ = invertedGenerationalDistance_;
+
+        fileStream_ << metrics.generation_ << " " << metrics.numberOfNonDominatedIndividuals_ << " "
+                    << metrics.archiveSize_ << " " << metrics.hypervolume_ << " "
+                    << metrics.invertedGenerationalDistance_ << std::endl;
+        if( !fileStream_ )
+        {
+            throw std::runtime_error( "Error when writing multi-objective metrics to " + filePath_ );
+        }
+
+        return metrics;
+    }
+
+    //! Function to retrieve the archive of all non-dominated points found so far
+    const ParetoFrontArchive& getArchive( ) const
+    {
+        return archive_;
+    }
+
+private:
+
+    //! Function to update the IGD, using the archived points starting at the given index
+    void updateInvertedGenerationalDistance( const std::size_t firstPointIndex, const bool resetDistances )
+    {
+        const std::vector< pagmo::vector_double >& archivedPoints = archive_.getFitnessVectors( );
+
+        double distanceSum = 0.0;
+        for( unsigned int i = 0; i < referenceFront_.size( ); i++ )
+        {
+            if( resetDistances )
+            {
+                closestArchiveDistances_.at( i ) = std::numeric_limits< double >::infinity( );
+            }
+
+            for( std::size_t j = firstPointIndex; j < archivedPoints.size( ); j++ )
+            {
+                double squaredDistance = 0.0;
+                for( unsigned int k = 0; k < referenceFront_.at( i ).size( ); k++ )
+                {
+                    const double difference = archivedPoints.at( j ).at( k ) - referenceFront_.at( i ).at( k );
+                    squaredDistance += difference * difference;
+                }
+                closestArchiveDistances_.at( i ) = std::min( closestArchiveDistances_.at( i ), std::sqrt( squaredDistance ) );
+            }
+            distanceSum += closestArchiveDistances_.at( i );
+        }
+        invertedGenerationalDistance_ = distanceSum / static_cast< double >( referenceFront_.size( ) );
+    }
+
+    std::string filePath_;
+
+    std::ofstream fileStream_;
+
+    pagmo::vector_double hypervolumeReferencePoint_;
+
+    std::vector< pagmo::vector_double > referenceFront_;
+
+    ParetoFrontArchive archive_;
+
+    //! Distance from each point of the reference front to the closest archived point
+    std::vector< double > closestArchiveDistances_;
+
+    double hypervolume_;
+
+    double invertedGenerationalDistance_;
+};
+
+}
+
+#endif // TUDAT_PAGMO_MULTI_OBJECTIVE_METRICS_H
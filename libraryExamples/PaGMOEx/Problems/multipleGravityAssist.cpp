@@ -21,8 +21,17 @@ using namespace pagmo;
 
 MultipleGravityAssist::MultipleGravityAssist(std::vector< std::vector< double > > &bounds,
                                              std::vector< int > flybySequence,
-                                             const bool useTripTime ):
-    problemBounds_( bounds ), useTripTime_( useTripTime )
+                                             const bool useTripTime,
+                                             const bool useTrajectoryWorkspace,
+                                             const double lambertCacheEpochResolution,
+                                             const unsigned int maximumNumberOfCachedLambertSolutions ):
+    problemBounds_( bounds ), useTripTime_( useTripTime ),
+    useTrajectoryWorkspace_( useTrajectoryWorkspace || lambertCacheEpochResolution > 0.0 ),
+    lambertCacheEpochResolution_( lambertCacheEpochResolution ),
+    maximumNumberOfCachedLambertSolutions_( maximumNumberOfCachedLambertSolutions ),
+    numberOfLambertCacheHits_( std::make_shared< std::atomic< unsigned long long > >( 0 ) ),
+    numberOfLambertCacheLookups_( std::make_shared< std::atomic< unsigned long long > >( 0 ) ),
+    flybySequence_( flybySequence )
 {
 
     // Specify required parameters
@@ -106,8 +115,8 @@ MultipleGravityAssist::MultipleGravityAssist(std::vector< std::vector< double >
     // Create departure and capture variables.
     semiMajorAxes_.resize( 2 );
     eccentricities_.resize( 2 );
-    semiMajorAxes_ << std::numeric_limits< double >::infinity( ), 1.0895e8 / 0.02;
-    eccentricities_ << 0., 0.98;
+    semiMajorAxes_ << getMgaDepartureSemiMajorAxis( ), getMgaCaptureSemiMajorAxis( );
+    eccentricities_ << getMgaDepartureEccentricity( ), getMgaCaptureEccentricity( );
 
 }
 //! Descriptive name of the problem
@@ -124,17 +133,69 @@ std::pair<std::vector<double>, std::vector<double> > MultipleGravityAssist::get_
 //! Implementation of the fitness function (return delta-v)
 std::vector<double> MultipleGravityAssist::fitness( const std::vector<double> &xv ) const{
     // Sun gravitational parameter
-    const double sunGravitationalParameter = 1.32712428e20;
+    const double sunGravitationalParameter = getMgaSunGravitationalParameter( );
+
+    double resultingDeltaV;
+    if( useTrajectoryWorkspace_ )
+    {
+        // Evaluate trajectory in the workspace owned by the current thread, reusing its buffers between evaluations
+        thread_local MgaTrajectoryWorkspace trajectoryWorkspace;
+        trajectoryWorkspace.resize( numberOfLegs_ );
+        if( lambertCacheEpochResolution_ > 0.0 )
+        {
+            // Lambert arcs are cached per thread (with the maximum number of solutions set when the cache is created), so
+            // hits are counted from the change in this thread's cache statistics
+            LambertSolutionCache& lambertSolutionCache =
+                    getThreadLocalLambertSolutionCache( maximumNumberOfCachedLambertSolutions_ );
+            const unsigned long long previousNumberOfHits = lambertSolutionCache.getNumberOfHits( );
+
+            resultingDeltaV = trajectoryWorkspace.computeDeltaV(
+                        xv, ephemerisVector_, gravitationalParameterVector_, minimumPericenterRadii_,
+                        semiMajorAxes_, eccentricities_, sunGravitationalParameter,
+                        flybySequence_, lambertCacheEpochResolution_, &lambertSolutionCache );
+
+            *numberOfLambertCacheHits_ += lambertSolutionCache.getNumberOfHits( ) - previousNumberOfHits;
+            *numberOfLambertCacheLookups_ += numberOfLegs_ - 1;
+        }
+        else
+        {
+            resultingDeltaV = trajectoryWorkspace.computeDeltaV(
+                        xv, ephemerisVector_, gravitationalParameterVector_, minimumPericenterRadii_,
+                        semiMajorAxes_, eccentricities_, sunGravitationalParameter );
+        }
+    }
+    else
+    {
+        resultingDeltaV = computeDeltaVFromTrajectory( xv, sunGravitationalParameter );
+    }
+
+    if (std::isnan(resultingDeltaV))
+    {
+        resultingDeltaV = 1.0E10;
+    }
+
+    if ( useTripTime_ ){
+        double TOF = 0;
+        for(int i = 1; i < numberOfLegs_ ; i++){
+            TOF += xv[i];
+        }
+        return { resultingDeltaV, TOF };
+    }
+    else {
+        return { resultingDeltaV };
+    }
+
+}
+
+//! Compute the Delta V using a new Tudat Trajectory object
+double MultipleGravityAssist::computeDeltaVFromTrajectory( const std::vector< double > &xv,
+                                                           const double sunGravitationalParameter ) const{
 
     // Create variable vector.
     Eigen::VectorXd variableVector ( numberOfLegs_ + 1 );
 
-    double TOF = 0;
     for(int i = 0; i < numberOfLegs_ ; i++){
         variableVector[ i ] = xv[ i ];
-        if( i > 0 ){
-            TOF += xv[i];
-        }
     }
     variableVector[ numberOfLegs_ ] = 1;//dummy
     variableVector *= physical_constants::JULIAN_DAY;
@@ -148,18 +209,7 @@ std::vector<double> MultipleGravityAssist::fitness( const std::vector<double> &x
     double resultingDeltaV;
     mgaTraj.calculateTrajectory( resultingDeltaV );
 
-    if (std::isnan(resultingDeltaV))
-    {
-        resultingDeltaV = 1.0E10;
-    }
-
-    if ( useTripTime_ ){
-        return { resultingDeltaV, TOF };
-    }
-    else {
-        return { resultingDeltaV };
-    }
-
+    return resultingDeltaV;
 }
 
 
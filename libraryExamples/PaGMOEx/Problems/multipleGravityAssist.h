@@ -12,6 +12,8 @@
 #define TUDAT_EXAMPLE_PAGMO_MULTIPLE_GRAVITY_ASSIST_H
 
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <utility>
 #include <limits>
@@ -29,6 +31,7 @@
 
 #include "Tudat/Astrodynamics/Ephemerides/approximatePlanetPositions.h"
 #include "Tudat/Astrodynamics/TrajectoryDesign/trajectory.h"
+#include "mgaTrajectoryWorkspace.h"
 #include <random>
 
 #include "pagmo/island.hpp"
@@ -54,11 +57,22 @@ using namespace pagmo;
 struct MultipleGravityAssist
 {
 
-    MultipleGravityAssist( const bool useTripTime = false ): useTripTime_( useTripTime ){ }
+    MultipleGravityAssist( const bool useTripTime = false ): useTripTime_( useTripTime ), useTrajectoryWorkspace_( false ),
+        lambertCacheEpochResolution_( 0.0 ), maximumNumberOfCachedLambertSolutions_( 0 ),
+        numberOfLambertCacheHits_( std::make_shared< std::atomic< unsigned long long > >( 0 ) ),
+        numberOfLambertCacheLookups_( std::make_shared< std::atomic< unsigned long long > >( 0 ) ){ }
 
+    //! Constructor, with sequence of flyby bodies, and boolean denoting whether the trajectory is evaluated using a per-thread
+    //! preallocated workspace (see MgaTrajectoryWorkspace), instead of a new Tudat Trajectory object for each evaluation.
+    //! If a Lambert cache epoch resolution (in days) is provided, the epochs at the bodies are rounded to this resolution,
+    //! and the Lambert arc solutions are memoized in a least-recently-used cache of each thread (the workspace is then
+    //! always used), so that they are reused by other individuals and generations.
     MultipleGravityAssist( std::vector< std::vector< double > > &bounds,
                            std::vector< int > flybySequence,
-                           const bool useTripTime = false );
+                           const bool useTripTime = false,
+                           const bool useTrajectoryWorkspace = false,
+                           const double lambertCacheEpochResolution = 0.0,
+                           const unsigned int maximumNumberOfCachedLambertSolutions = 100000 );
 
     // Calculates the fitness
     std::vector< double > fitness( const std::vector< double > &x ) const;
@@ -73,6 +87,14 @@ struct MultipleGravityAssist
         ar(problemBounds_);
     }
 
+    //! Function to retrieve the fraction of Lambert arcs that was retrieved from the cache (over all copies of the problem)
+    double getLambertCacheHitRate( ) const
+    {
+        const unsigned long long numberOfLookups = *numberOfLambertCacheLookups_;
+        return ( numberOfLookups == 0 ) ? 0.0 :
+                                          static_cast< double >( *numberOfLambertCacheHits_ ) / numberOfLookups;
+    }
+
     vector_double::size_type get_nobj() const
     {
         if(useTripTime_ )
@@ -88,11 +110,27 @@ struct MultipleGravityAssist
 
 private:
 
+    //! Compute the Delta V using a new Tudat Trajectory object
+    double computeDeltaVFromTrajectory( const std::vector< double > &xv, const double sunGravitationalParameter ) const;
+
     const std::vector< std::vector< double > > problemBounds_;
 
     bool useTripTime_;
 
+    bool useTrajectoryWorkspace_;
+
+    //! Resolution (in days) of epochs for Lambert arc memoization (0 if not used)
+    double lambertCacheEpochResolution_;
+
+    unsigned int maximumNumberOfCachedLambertSolutions_;
+
+    //! Number of Lambert arcs retrieved from cache, and number of cache lookups, shared by all copies of the problem
+    std::shared_ptr< std::atomic< unsigned long long > > numberOfLambertCacheHits_;
+
+    std::shared_ptr< std::atomic< unsigned long long > > numberOfLambertCacheLookups_;
+
     int numberOfLegs_;
+    std::vector< int > flybySequence_;
     std::vector< TransferLegType > legTypeVector_;
     std::vector< std::string > bodyNamesVector_;
     std::vector< ephemerides::EphemerisPointer > ephemerisVector_;
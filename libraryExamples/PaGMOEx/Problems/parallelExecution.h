@@ -0,0 +1,188 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_PARALLEL_EXECUTION_H
+#define TUDAT_PAGMO_PARALLEL_EXECUTION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tudat_pagmo_applications
+{
+
+//! Function to retrieve the number of threads to use, with 0 denoting all available hardware threads
+inline unsigned int getNumberOfThreadsToUse( const unsigned int requestedNumberOfThreads = 0 )
+{
+    if( requestedNumberOfThreads > 0 )
+    {
+        return requestedNumberOfThreads;
+    }
+    return std::max( std::thread::hardware_concurrency( ), 1u );
+}
+
+//! Range of task indices owned by a single worker thread, from which other threads may steal.
+struct WorkStealingTaskRange
+{
+    WorkStealingTaskRange( ): begin_( 0 ), end_( 0 ){ }
+
+    //! Retrieve next task of the owning thread (taken from front of range)
+    bool popFront( std::size_t& taskIndex )
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        if( begin_ >= end_ )
+        {
+            return false;
+        }
+        taskIndex = begin_++;
+        return true;
+    }
+
+    //! Steal the back half of the remaining tasks (at least one) from this range
+    bool stealBack( std::size_t& stolenBegin, std::size_t& stolenEnd )
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        if( begin_ >= end_ )
+        {
+            return false;
+        }
+        const std::size_t numberOfStolenTasks = std::max< std::size_t >( ( end_ - begin_ ) / 2, 1 );
+        stolenEnd = end_;
+        stolenBegin = end_ - numberOfStolenTasks;
+        end_ = stolenBegin;
+        return true;
+    }
+
+    //! Reset the range owned by this thread
+    void reset( const std::size_t begin, const std::size_t end )
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        begin_ = begin;
+        end_ = end;
+    }
+
+    std::mutex mutex_;
+    std::size_t begin_;
+    std::size_t end_;
+};
+
+//! Function to execute a set of independent tasks on a set of threads.
+/*!
+ *  Function to execute a set of independent tasks on a set of threads. The tasks are initially distributed in contiguous
+ *  blocks over the threads. A thread that has finished its own tasks steals half of the remaining tasks of another thread,
+ *  so that a thread that is stuck on expensive tasks does not stall the complete computation. The first exception thrown by
+ *  any task is rethrown on the calling thread, after all threads have been joined.
+ *  \param numberOfTasks Number of tasks to execute
+ *  \param taskFunction Function executing a single task, taking the task index and the index of the executing thread.
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ */
+inline void executeTasksInParallel(
+        const std::size_t numberOfTasks,
+        const std::function< void( const std::size_t taskIndex, const unsigned int threadIndex ) >& taskFunction,
+        const unsigned int numberOfThreads = 0 )
+{
+    const unsigned int numberOfWorkers = static_cast< unsigned int >(
+                std::min< std::size_t >( getNumberOfThreadsToUse( numberOfThreads ), std::max< std::size_t >( numberOfTasks, 1 ) ) );
+
+    // Run on calling thread if no parallelism is possible
+    if( numberOfWorkers == 1 )
+    {
+        for( std::size_t i = 0; i < numberOfTasks; i++ )
+        {
+            taskFunction( i, 0 );
+        }
+        return;
+    }
+
+    // Distribute tasks over threads in contiguous blocks
+    std::vector< std::unique_ptr< WorkStealingTaskRange > > taskRanges;
+    for( unsigned int i = 0; i < numberOfWorkers; i++ )
+    {
+        taskRanges.push_back( std::unique_ptr< WorkStealingTaskRange >( new WorkStealingTaskRange( ) ) );
+        taskRanges.back( )->reset( numberOfTasks * i / numberOfWorkers, numberOfTasks * ( i + 1 ) / numberOfWorkers );
+    }
+
+    std::mutex exceptionMutex;
+    std::exception_ptr firstException;
+    std::atomic< bool > hasTaskFailed( false );
+
+    auto workerFunction = [ & ]( const unsigned int threadIndex )
+    {
+        try
+        {
+            std::size_t taskIndex;
+            while( true )
+            {
+                // Process own tasks, stopping all threads if an exception has been thrown
+                while( !hasTaskFailed && taskRanges.at( threadIndex )->popFront( taskIndex ) )
+                {
+                    taskFunction( taskIndex, threadIndex );
+                }
+                if( hasTaskFailed )
+                {
+                    break;
+                }
+
+                // Steal from other threads, starting at the neighbouring thread
+                bool hasStolenTasks = false;
+                for( unsigned int i = 1; i < numberOfWorkers && !hasStolenTasks; i++ )
+                {
+                    std::size_t stolenBegin, stolenEnd;
+                    if( taskRanges.at( ( threadIndex + i ) % numberOfWorkers )->stealBack( stolenBegin, stolenEnd ) )
+                    {
+                        taskRanges.at( threadIndex )->reset( stolenBegin, stolenEnd );
+                        hasStolenTasks = true;
+                    }
+                }
+
+                if( !hasStolenTasks )
+                {
+                    break;
+                }
+            }
+        }
+        catch( ... )
+        {
+            std::lock_guard< std::mutex > lock( exceptionMutex );
+            if( !firstException )
+            {
+                firstException = std::current_exception( );
+            }
+            hasTaskFailed = true;
+        }
+    };
+
+    std::vector< std::thread > workerThreads;
+    for( unsigned int i = 1; i < numberOfWorkers; i++ )
+    {
+        workerThreads.push_back( std::thread( workerFunction, i ) );
+    }
+    workerFunction( 0 );
+
+    for( unsigned int i = 0; i < workerThreads.size( ); i++ )
+    {
+        workerThreads.at( i ).join( );
+    }
+
+    if( firstException )
+    {
+        std::rethrow_exception( firstException );
+    }
+}
+
+}
+
+#endif // TUDAT_PAGMO_PARALLEL_EXECUTION_H
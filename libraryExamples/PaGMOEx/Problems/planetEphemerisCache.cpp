@@ -0,0 +1,48 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <stdexcept>
+
+#include "planetEphemerisCache.h"
+
+PlanetEphemerisCache::PlanetEphemerisCache( const std::function< StateType( const double ) > stateFunction,
+                                            const double startJulianDay,
+                                            const double endJulianDay,
+                                            const double nodeSpacing ):
+    startJulianDay_( startJulianDay ), endJulianDay_( endJulianDay ),
+    inverseNodeSpacing_( 1.0 / nodeSpacing ), nodeSpacingInSeconds_( nodeSpacing * 86400.0 )
+{
+    if( !( endJulianDay > startJulianDay ) || !( nodeSpacing > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when creating planet ephemeris cache, invalid time interval or node spacing." );
+    }
+
+    // Time step (in days) used for central difference of state function
+    const double differenceStep = 1.0E-3 * nodeSpacing;
+
+    // Set nodes such that the complete interval is covered
+    numberOfNodes_ = static_cast< int >( std::ceil( ( endJulianDay - startJulianDay ) / nodeSpacing ) ) + 1;
+    nodeData_.resize( numberOfNodes_ * entriesPerNode );
+
+    for( int i = 0; i < numberOfNodes_; i++ )
+    {
+        const double nodeJulianDay = startJulianDay + static_cast< double >( i ) * nodeSpacing;
+        const StateType nodeState = stateFunction( nodeJulianDay );
+        const StateType nodeStateDerivative =
+                ( stateFunction( nodeJulianDay + differenceStep ) - stateFunction( nodeJulianDay - differenceStep ) ) /
+                ( 2.0 * differenceStep * 86400.0 );
+
+        for( int j = 0; j < 6; j++ )
+        {
+            nodeData_[ i * entriesPerNode + j ] = nodeState( j );
+            nodeData_[ i * entriesPerNode + 6 + j ] = nodeStateDerivative( j );
+        }
+    }
+}
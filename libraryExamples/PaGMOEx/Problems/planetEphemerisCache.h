@@ -0,0 +1,99 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_PLANET_EPHEMERIS_CACHE_H
+#define TUDAT_EXAMPLE_PAGMO_PLANET_EPHEMERIS_CACHE_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include <Eigen/Core>
+
+//! Table of planet states, from which states at arbitrary epochs are obtained by cubic Hermite interpolation.
+/*!
+ *  Table of planet states, from which states at arbitrary epochs are obtained by cubic Hermite interpolation. The table is
+ *  generated once from an (expensive) state function, at equidistant Julian days. At each node, the state and its time
+ *  derivative are stored contiguously. The derivative is computed by central differences of the state function, so that the
+ *  interpolation is consistent with the state function, even if its velocity is not exactly the derivative of its position.
+ *  With a one-day node spacing, the interpolation error for the inner planets is in the order of tens of meters.
+ */
+class PlanetEphemerisCache
+{
+public:
+
+    typedef Eigen::Matrix< double, 6, 1 > StateType;
+
+    //! Constructor
+    /*!
+     *  Constructor, computes the table of states.
+     *  \param stateFunction Function returning the Cartesian state of the planet as a function of Julian day
+     *  \param startJulianDay First Julian day for which states are to be interpolated
+     *  \param endJulianDay Last Julian day for which states are to be interpolated
+     *  \param nodeSpacing Spacing (in days) between nodes of table
+     */
+    PlanetEphemerisCache( const std::function< StateType( const double ) > stateFunction,
+                          const double startJulianDay,
+                          const double endJulianDay,
+                          const double nodeSpacing = 1.0 );
+
+    //! Function to check whether the cache can be used at a given Julian day
+    bool isJulianDayInRange( const double julianDay ) const
+    {
+        return ( julianDay >= startJulianDay_ ) && ( julianDay <= endJulianDay_ );
+    }
+
+    //! Function to interpolate the state at a given Julian day (must be in range, see isJulianDayInRange).
+    template< typename OutputType >
+    void getState( const double julianDay, OutputType&& state ) const
+    {
+        // Find interval and normalized time in interval
+        const double scaledTime = ( julianDay - startJulianDay_ ) * inverseNodeSpacing_;
+        const int intervalIndex = std::min( static_cast< int >( scaledTime ), numberOfNodes_ - 2 );
+        const double s = scaledTime - static_cast< double >( intervalIndex );
+
+        // Cubic Hermite basis functions; derivative terms are scaled by interval length (in seconds)
+        const double s2 = s * s;
+        const double s3 = s2 * s;
+        const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+        const double h10 = ( s3 - 2.0 * s2 + s ) * nodeSpacingInSeconds_;
+        const double h01 = -2.0 * s3 + 3.0 * s2;
+        const double h11 = ( s3 - s2 ) * nodeSpacingInSeconds_;
+
+        const double* lowerNode = &nodeData_[ intervalIndex * entriesPerNode ];
+        const double* upperNode = lowerNode + entriesPerNode;
+        for( int i = 0; i < 6; i++ )
+        {
+            state( i ) = h00 * lowerNode[ i ] + h10 * lowerNode[ i + 6 ] +
+                    h01 * upperNode[ i ] + h11 * upperNode[ i + 6 ];
+        }
+    }
+
+private:
+
+    //! Number of entries per node: state and state derivative
+    static const int entriesPerNode = 12;
+
+    double startJulianDay_;
+
+    double endJulianDay_;
+
+    double inverseNodeSpacing_;
+
+    double nodeSpacingInSeconds_;
+
+    int numberOfNodes_;
+
+    //! State and state derivative at all nodes, stored contiguously
+    std::vector< double > nodeData_;
+};
+
+#endif // TUDAT_EXAMPLE_PAGMO_PLANET_EPHEMERIS_CACHE_H
@@ -0,0 +1,275 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_PAGMO_POPULATION_SNAPSHOT_H
+#define TUDAT_PAGMO_POPULATION_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <pagmo/types.hpp>
+
+namespace tudat_pagmo_applications
+{
+
+//! Identifier at the start of each population snapshot file
+static const char populationSnapshotFileIdentifier[ 8 ] = { 'T', 'U', 'D', 'A', 'T', 'P', 'O', 'P' };
+
+//! Version of population snapshot file format
+static const std::uint32_t populationSnapshotFileVersion = 1;
+
+//! Header of population snapshot file.
+/*!
+ *  Header of population snapshot file. A population snapshot file consists of this header, followed by one fixed-size
+ *  record per snapshot (typically one per generation). Each record contains the generation number (as uint64), the decision
+ *  vectors of all individuals (numberOfIndividuals_ x decisionVectorSize_ doubles, one individual after the other), and the
+ *  fitness vectors of all individuals (numberOfIndividuals_ x fitnessVectorSize_ doubles, idem). All data is stored in native
+ *  (in practice little-endian) byte order, and all fields are aligned to 8 bytes, so that the file may be memory-mapped,
+ *  with record k starting at byte headerSize_ + k * recordSize.
+ */
+struct PopulationSnapshotFileHeader
+{
+    char fileIdentifier_[ 8 ];
+
+    std::uint32_t version_;
+
+    std::uint32_t headerSize_;
+
+    std::uint64_t numberOfIndividuals_;
+
+    std::uint64_t decisionVectorSize_;
+
+    std::uint64_t fitnessVectorSize_;
+
+    //! Function to retrieve the size (in bytes) of a single record
+    std::uint64_t getRecordSize( ) const
+    {
+        return sizeof( std::uint64_t ) +
+                numberOfIndividuals_ * ( decisionVectorSize_ + fitnessVectorSize_ ) * sizeof( double );
+    }
+};
+
+static_assert( sizeof( PopulationSnapshotFileHeader ) == 40, "Population snapshot file header must not contain padding" );
+
+//! Snapshot of a population (decision and fitness vectors) at a given generation.
+/*!
+ *  Snapshot of a population (decision and fitness vectors) at a given generation. The snapshot is move-only, so that it can
+ *  be passed to an asynchronous writer (see AsynchronousOutputQueue) without copying the population.
+ */
+struct PopulationSnapshot
+{
+    PopulationSnapshot( const unsigned int generation,
+                        std::vector< pagmo::vector_double >&& decisionVectors,
+                        std::vector< pagmo::vector_double >&& fitnessVectors ):
+        generation_( generation ), decisionVectors_( std::move( decisionVectors ) ),
+        fitnessVectors_( std::move( fitnessVectors ) ){ }
+
+    PopulationSnapshot( PopulationSnapshot&& ) = default;
+
+    PopulationSnapshot& operator=( PopulationSnapshot&& ) = default;
+
+    PopulationSnapshot( const PopulationSnapshot& ) = delete;
+
+    PopulationSnapshot& operator=( const PopulationSnapshot& ) = delete;
+
+    unsigned int generation_;
+
+    std::vector< pagmo::vector_double > decisionVectors_;
+
+    std::vector< pagmo::vector_double > fitnessVectors_;
+};
+
+//! Class to write snapshots of a population (decision and fitness vectors) to a binary file, one record per snapshot.
+/*!
+ *  Class to write snapshots of a population (decision and fitness vectors) to a binary file, one record per snapshot (see
+ *  PopulationSnapshotFileHeader for the file format). All snapshots of a single run are written to the same file. The file
+ *  is flushed after each snapshot, so that it may be read while the run is in progress. Snapshots may be appended to an
+ *  existing file with the same population dimensions (e.g. when resuming a run), in which case any incomplete final record
+ *  is discarded. The file may be read in MATLAB using Analysis/readPopulationSnapshots.m.
+ */
+class PopulationSnapshotWriter
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor, opens the file and writes the header (if not appending to an existing file)
+     *  \param filePath Path of snapshot file (directories are created if needed)
+     *  \param numberOfIndividuals Number of individuals in each snapshot
+     *  \param decisionVectorSize Size of the decision vector of each individual
+     *  \param fitnessVectorSize Size of the fitness vector of each individual
+     *  \param appendToExistingFile Boolean denoting whether snapshots are to be appended to the file, if it exists (file is
+     *  overwritten if false)
+     */
+    PopulationSnapshotWriter( const std::string& filePath,
+                              const std::size_t numberOfIndividuals,
+                              const std::size_t decisionVectorSize,
+                              const std::size_t fitnessVectorSize,
+                              const bool appendToExistingFile = false ):
+        filePath_( filePath ), numberOfSnapshots_( 0 )
+    {
+        std::memcpy( header_.fileIdentifier_, populationSnapshotFileIdentifier, sizeof( header_.fileIdentifier_ ) );
+        header_.version_ = populationSnapshotFileVersion;
+        header_.headerSize_ = sizeof( PopulationSnapshotFileHeader );
+        header_.numberOfIndividuals_ = numberOfIndividuals;
+        header_.decisionVectorSize_ = decisionVectorSize;
+        header_.fitnessVectorSize_ = fitnessVectorSize;
+
+        recordBuffer_.resize( numberOfIndividuals * ( decisionVectorSize + fitnessVectorSize ) );
+
+        const boost::filesystem::path parentPath = boost::filesystem::path( filePath ).parent_path( );
+        if( !parentPath.empty( ) )
+        {
+            boost::filesystem::create_directories( parentPath );
+        }
+
+        if( appendToExistingFile && boost::filesystem::exists( filePath ) )
+        {
+            openExistingFile( );
+        }
+        else
+        {
+            fileStream_.open( filePath, std::ios::binary | std::ios::trunc );
+            if( !fileStream_ )
+            {
+                throw std::runtime_error( "Error when creating population snapshot file " + filePath );
+            }
+            fileStream_.write( reinterpret_cast< const char* >( &header_ ), sizeof( header_ ) );
+            fileStream_.flush( );
+        }
+    }
+
+    //! Function to write a snapshot of the population to the file
+    /*!
+     *  Function to write a snapshot of the population to the file
+     *  \param generation Generation number of the snapshot
+     *  \param decisionVectors Decision vectors of all individuals
+     *  \param fitnessVectors Fitness vectors of all individuals
+     */
+    void writeSnapshot( const unsigned int generation,
+                        const std::vector< pagmo::vector_double >& decisionVectors,
+                        const std::vector< pagmo::vector_double >& fitnessVectors )
+    {
+        if( decisionVectors.size( ) != header_.numberOfIndividuals_ ||
+                fitnessVectors.size( ) != header_.numberOfIndividuals_ )
+        {
+            throw std::runtime_error( "Error when writing population snapshot to " + filePath_ +
+                                      ", number of individuals is inconsistent with file." );
+        }
+
+        // Copy decision and fitness vectors into contiguous record
+        double* currentEntry = recordBuffer_.data( );
+        for( unsigned int i = 0; i < decisionVectors.size( ); i++ )
+        {
+            copyVectorToRecord( decisionVectors.at( i ), header_.decisionVectorSize_, currentEntry );
+        }
+        for( unsigned int i = 0; i < fitnessVectors.size( ); i++ )
+        {
+            copyVectorToRecord( fitnessVectors.at( i ), header_.fitnessVectorSize_, currentEntry );
+        }
+
+        const std::uint64_t generationToWrite = generation;
+        fileStream_.write( reinterpret_cast< const char* >( &generationToWrite ), sizeof( generationToWrite ) );
+        fileStream_.write( reinterpret_cast< const char* >( recordBuffer_.data( ) ),
+                           recordBuffer_.size( ) * sizeof( double ) );
+        fileStream_.flush( );
+        if( !fileStream_ )
+        {
+            throw std::runtime_error( "Error when writing population snapshot to " + filePath_ );
+        }
+
+        numberOfSnapshots_++;
+    }
+
+    //! Function to write a snapshot of the population to the file
+    void writeSnapshot( const PopulationSnapshot& snapshot )
+    {
+        writeSnapshot( snapshot.generation_, snapshot.decisionVectors_, snapshot.fitnessVectors_ );
+    }
+
+    //! Function to retrieve the number of snapshots in the file (including those present before appending)
+    std::size_t getNumberOfSnapshots( ) const
+    {
+        return numberOfSnapshots_;
+    }
+
+private:
+
+    //! Function to open an existing file for appending, after checking its header and discarding any incomplete record
+    void openExistingFile( )
+    {
+        PopulationSnapshotFileHeader existingHeader;
+        {
+            std::ifstream inputStream( filePath_, std::ios::binary );
+            inputStream.read( reinterpret_cast< char* >( &existingHeader ), sizeof( existingHeader ) );
+            if( !inputStream ||
+                    std::memcmp( existingHeader.fileIdentifier_, header_.fileIdentifier_, sizeof( header_.fileIdentifier_ ) ) != 0 ||
+                    existingHeader.version_ != header_.version_ ||
+                    existingHeader.headerSize_ != header_.headerSize_ ||
+                    existingHeader.numberOfIndividuals_ != header_.numberOfIndividuals_ ||
+                    existingHeader.decisionVectorSize_ != header_.decisionVectorSize_ ||
+                    existingHeader.fitnessVectorSize_ != header_.fitnessVectorSize_ )
+            {
+                throw std::runtime_error( "Error when appending to population snapshot file " + filePath_ +
+                                          ", existing file has incompatible header." );
+            }
+        }
+
+        const std::uint64_t recordSize = header_.getRecordSize( );
+        const std::uint64_t fileSize = boost::filesystem::file_size( filePath_ );
+        numberOfSnapshots_ = ( fileSize - header_.headerSize_ ) / recordSize;
+        const std::uint64_t completeFileSize = header_.headerSize_ + numberOfSnapshots_ * recordSize;
+        if( fileSize != completeFileSize )
+        {
+            boost::filesystem::resize_file( filePath_, completeFileSize );
+        }
+
+        fileStream_.open( filePath_, std::ios::binary | std::ios::app );
+        if( !fileStream_ )
+        {
+            throw std::runtime_error( "Error when opening population snapshot file " + filePath_ );
+        }
+    }
+
+    //! Function to copy a single vector into the record buffer, advancing the current entry
+    void copyVectorToRecord( const pagmo::vector_double& vectorToCopy, const std::uint64_t expectedSize,
+                             double*& currentEntry ) const
+    {
+        if( vectorToCopy.size( ) != expectedSize )
+        {
+            throw std::runtime_error( "Error when writing population snapshot to " + filePath_ +
+                                      ", vector size is inconsistent with file." );
+        }
+        std::memcpy( currentEntry, vectorToCopy.data( ), vectorToCopy.size( ) * sizeof( double ) );
+        currentEntry += vectorToCopy.size( );
+    }
+
+    std::string filePath_;
+
+    PopulationSnapshotFileHeader header_;
+
+    std::ofstream fileStream_;
+
+    //! Buffer in which the decision and fitness vectors of a single snapshot are collected
+    std::vector< double > recordBuffer_;
+
+    std::size_t numberOfSnapshots_;
+};
+
+}
+
+#endif // TUDAT_PAGMO_POPULATION_SNAPSHOT_H
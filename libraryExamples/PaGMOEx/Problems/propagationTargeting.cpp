@@ -15,13 +15,174 @@
 
 using namespace tudat;
 
+//! Step size of numerical propagation (fixed step), and of grid on which the distance is evaluated for analytic propagation
+const double targetingPropagationStepSize = 30.0;
+
+//! Function to check out an environment from the pool
+std::shared_ptr< PropagationTargetingEnvironment > PropagationTargetingEnvironmentPool::acquireEnvironment( )
+{
+    std::unique_ptr< PropagationTargetingEnvironment > environment;
+    {
+        std::lock_guard< std::mutex > lock( poolMutex_ );
+        if( !availableEnvironments_.empty( ) )
+        {
+            environment = std::move( availableEnvironments_.back( ) );
+            availableEnvironments_.pop_back( );
+        }
+    }
+
+    if( environment == nullptr )
+    {
+        environment = environmentCreationFunction_( );
+    }
+
+    return std::shared_ptr< PropagationTargetingEnvironment >(
+                environment.release( ), [ this ]( PropagationTargetingEnvironment* environmentToRelease )
+    {
+        releaseEnvironment( environmentToRelease );
+    } );
+}
+
+//! Function to return an environment to the pool
+void PropagationTargetingEnvironmentPool::releaseEnvironment( PropagationTargetingEnvironment* environment )
+{
+    std::lock_guard< std::mutex > lock( poolMutex_ );
+    availableEnvironments_.push_back( std::unique_ptr< PropagationTargetingEnvironment >( environment ) );
+}
+
+//! Function to create the environment, acceleration models and dynamics simulator for the targeting problem
+std::unique_ptr< PropagationTargetingEnvironment > createPropagationTargetingEnvironment(
+        const double simulationStartEpoch, const double simulationEndEpoch, const bool useExtendedDynamics,
+        const std::shared_ptr< propagators::DependentVariableSaveSettings > dependentVariablesToSave,
+        const double maximumDistanceRate )
+{
+    using namespace tudat::simulation_setup;
+    using namespace tudat::propagators;
+    using namespace tudat::numerical_integrators;
+
+    // Spice is not thread-safe, so environments are created one at a time
+    static std::mutex environmentCreationMutex;
+    std::lock_guard< std::mutex > lock( environmentCreationMutex );
+
+    // Create the body Earth from Spice interface
+    std::map< std::string, std::shared_ptr< BodySettings > > bodySettings;
+    if( useExtendedDynamics )
+    {
+        bodySettings =
+                getDefaultBodySettings( {"Earth", "Moon", "Sun"}, simulationStartEpoch - 3600.0, simulationEndEpoch + 3600.0 );
+        bodySettings[ "Moon" ]->rotationModelSettings->resetOriginalFrame( "J2000" );
+        bodySettings[ "Moon" ]->ephemerisSettings->resetFrameOrientation( "J2000" );
+        bodySettings[ "Sun" ]->rotationModelSettings->resetOriginalFrame( "J2000" );
+        bodySettings[ "Sun" ]->ephemerisSettings->resetFrameOrientation( "J2000" );
+    }
+    else
+    {
+        bodySettings =
+                getDefaultBodySettings( {"Earth"} );
+    }
+    bodySettings[ "Earth" ]->ephemerisSettings = std::make_shared< simulation_setup::ConstantEphemerisSettings >(
+                Eigen::Vector6d::Zero( ), "SSB", "J2000" );
+
+    bodySettings[ "Earth" ]->rotationModelSettings->resetOriginalFrame( "J2000" );
+    bodySettings[ "Earth" ]->ephemerisSettings->resetFrameOrientation( "J2000" );
+
+
+    //Create bodyMap and add the satellite as an empty body
+    std::unique_ptr< PropagationTargetingEnvironment > environment( new PropagationTargetingEnvironment( ) );
+    environment->bodyMap_ = simulation_setup::createBodies( bodySettings );
+    environment->bodyMap_["Satellite"] = std::make_shared<Body>();
+    setGlobalFrameBodyEphemerides( environment->bodyMap_, "Earth", "J2000" );
+
+    //Setup simulation. Simple Keplerian orbit (only central-gravity of Earth)
+    std::vector< std::string > bodiesToPropagate = { "Satellite" };
+    std::vector< std::string > centralBodies = { "Earth" };
+    SelectedAccelerationMap accelerationMap;
+    std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > accelerationsOfSatellite;
+    if( useExtendedDynamics )
+    {
+        accelerationsOfSatellite[ "Earth" ].push_back( std::make_shared< SphericalHarmonicAccelerationSettings >(
+                                                           2, 2 ) );
+        accelerationsOfSatellite[ "Moon" ].push_back( std::make_shared< AccelerationSettings >(
+                                                          basic_astrodynamics::point_mass_gravity ) );
+        accelerationsOfSatellite[ "Sun" ].push_back( std::make_shared< AccelerationSettings >(
+                                                         basic_astrodynamics::point_mass_gravity ) );
+        accelerationMap[ "Satellite" ] = accelerationsOfSatellite;
+    }
+    else
+    {
+        accelerationsOfSatellite[ "Earth" ].push_back( std::make_shared< AccelerationSettings >(
+                                                           basic_astrodynamics::point_mass_gravity ) );
+        accelerationMap[ "Satellite" ] = accelerationsOfSatellite;
+    }
+    basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                environment->bodyMap_, accelerationMap, bodiesToPropagate, centralBodies );
+
+    // Closest approach to the target is monitored during propagation, through a termination condition that inspects
+    // the state of the satellite after each step. The propagation is terminated when a lower bound on the closest approach
+    // (from the closest approach so far, and the current distance minus the maximum distance covered in the remaining
+    // time) exceeds the pruning threshold. The closest sample so far is reduced by the maximum distance covered in one
+    // step, since the interpolated closest approach may lie between samples.
+    PropagationTargetingEnvironment* environmentToMonitor = environment.get( );
+    std::function< bool( const double ) > closestApproachMonitoringFunction = [ = ]( const double currentTime )
+    {
+        ClosestApproachMonitor& closestApproachMonitor = environmentToMonitor->closestApproachMonitor_;
+        closestApproachMonitor.addSample(
+                    currentTime, environmentToMonitor->bodyMap_.at( "Satellite" )->getState( ) );
+
+        const double closestApproachLowerBound = std::min(
+                    closestApproachMonitor.getClosestSampledDistance( ) - maximumDistanceRate * targetingPropagationStepSize,
+                    closestApproachMonitor.getLatestSampledDistance( ) -
+                    maximumDistanceRate * ( simulationEndEpoch - currentTime ) );
+        if( closestApproachLowerBound > environmentToMonitor->pruningThreshold_ )
+        {
+            environmentToMonitor->isPropagationPruned_ = true;
+        }
+        return environmentToMonitor->isPropagationPruned_;
+    };
+    std::shared_ptr< PropagationTerminationSettings > terminationSettings =
+            std::make_shared< PropagationHybridTerminationSettings >(
+                std::vector< std::shared_ptr< PropagationTerminationSettings > >{
+                    std::make_shared< PropagationTimeTerminationSettings >( simulationEndEpoch ),
+                    std::make_shared< PropagationCustomTerminationSettings >( closestApproachMonitoringFunction ) },
+                true );
+
+    // The environment is only updated to the state at the end of each step when dependent variables are saved, so at
+    // least one dependent variable is always saved
+    std::shared_ptr< DependentVariableSaveSettings > dependentVariablesToSaveInEnvironment = dependentVariablesToSave;
+    if( dependentVariablesToSaveInEnvironment == nullptr )
+    {
+        dependentVariablesToSaveInEnvironment = std::make_shared< DependentVariableSaveSettings >(
+                    std::vector< std::shared_ptr< SingleDependentVariableSaveSettings > >{
+                        std::make_shared< SingleDependentVariableSaveSettings >(
+                        relative_distance_dependent_variable, "Satellite", "Earth" ) }, false );
+    }
+
+    //Setup propagator (cowell) and integrator (RK4 fixed stepsize). The initial state is set for each evaluation.
+    std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
+            std::make_shared< TranslationalStatePropagatorSettings< double > >
+            ( centralBodies, accelerationModelMap, bodiesToPropagate, Eigen::VectorXd::Zero( 6 ), terminationSettings,
+              cowell, dependentVariablesToSaveInEnvironment );
+    std::shared_ptr< IntegratorSettings< > > integratorSettings =
+            std::make_shared< IntegratorSettings< > >
+            ( rungeKutta4, simulationStartEpoch, targetingPropagationStepSize );
+
+    //Create simulator, without propagating
+    environment->dynamicsSimulator_ = std::make_shared< SingleArcDynamicsSimulator< > >(
+                environment->bodyMap_, integratorSettings, propagatorSettings, false, false, false );
+
+    return environment;
+}
+
+thread_local bool PropagationTargetingProblem::isLastEvaluationPruned_ = false;
+
 PropagationTargetingProblem::PropagationTargetingProblem(const double altitudeOfPerigee,
         const double altitudeOfApogee, const double altitudeOfTarget, const double longitudeOfTarget,
         const std::shared_ptr< propagators::DependentVariableSaveSettings> dependentVariablesToSave,
-        const bool useExtendedDynamics) :
+        const bool useExtendedDynamics, const bool useAnalyticKeplerPropagation ) :
     altitudeOfPerigee_( altitudeOfPerigee ), altitudeOfApogee_( altitudeOfApogee ),
     altitudeOfTarget_( altitudeOfTarget ), longitudeOfTarget_( longitudeOfTarget ), dependentVariablesToSave_( dependentVariablesToSave ),
-    useExtendedDynamics_( useExtendedDynamics )
+    useExtendedDynamics_( useExtendedDynamics ),
+    useAnalyticKeplerPropagation_( useAnalyticKeplerPropagation && !useExtendedDynamics )
 {
     using namespace tudat;
     using namespace tudat::simulation_setup;
@@ -45,37 +206,43 @@ PropagationTargetingProblem::PropagationTargetingProblem(const double altitudeOf
     simulationEndEpoch_ = 1.2 * mathematical_constants::PI *
             std::sqrt(pow(semiMajorAxis_,3)/earthGravitationalParameter_);
 
-    // Create the body Earth from Spice interface
-    std::map< std::string, std::shared_ptr< BodySettings > > bodySettings;
-    if( useExtendedDynamics_ )
-    {
-        bodySettings =
-                getDefaultBodySettings( {"Earth", "Moon", "Sun"}, simulationStartEpoch_ - 3600.0, simulationEndEpoch_ + 3600.0 );
-        bodySettings[ "Moon" ]->rotationModelSettings->resetOriginalFrame( "J2000" );
-        bodySettings[ "Moon" ]->ephemerisSettings->resetFrameOrientation( "J2000" );
-        bodySettings[ "Sun" ]->rotationModelSettings->resetOriginalFrame( "J2000" );
-        bodySettings[ "Sun" ]->ephemerisSettings->resetFrameOrientation( "J2000" );
-    }
-    else
-    {
-        bodySettings =
-                getDefaultBodySettings( {"Earth"} );
-    }
-    bodySettings[ "Earth" ]->ephemerisSettings = std::make_shared< simulation_setup::ConstantEphemerisSettings >(
-                Eigen::Vector6d::Zero( ), "SSB", "J2000" );
-
-    bodySettings[ "Earth" ]->rotationModelSettings->resetOriginalFrame( "J2000" );
-    bodySettings[ "Earth" ]->ephemerisSettings->resetFrameOrientation( "J2000" );
+    // Upper bound on rate of change of distance from target: velocity at perigee (Keplerian orbit) plus velocity of
+    // rotating frame at apogee radius, with a margin for perturbations
+    const double earthRotationRate = 2.0 * mathematical_constants::PI / physical_constants::SIDEREAL_DAY;
+    maximumDistanceRate_ = 1.1 * (
+                std::sqrt( earthGravitationalParameter_ * ( 2.0 / radiusOfPerigee_ - 1.0 / semiMajorAxis_ ) ) +
+                earthRotationRate * radiusOfApogee_ );
+    pruningThreshold_ = std::make_shared< std::atomic< double > >( std::numeric_limits< double >::infinity( ) );
+
+    // Create pool of environments; the first environment is created directly, so that any errors in its creation are
+    // reported here
+    const double simulationStartEpoch = simulationStartEpoch_;
+    const double simulationEndEpoch = simulationEndEpoch_;
+    const bool useExtendedDynamicsInEnvironment = useExtendedDynamics_;
+    const std::shared_ptr< propagators::DependentVariableSaveSettings > dependentVariablesToSaveInEnvironment =
+            dependentVariablesToSave_;
+    const double maximumDistanceRate = maximumDistanceRate_;
+    environmentPool_ = std::make_shared< PropagationTargetingEnvironmentPool >(
+                [ = ]( ){ return createPropagationTargetingEnvironment(
+                    simulationStartEpoch, simulationEndEpoch, useExtendedDynamicsInEnvironment,
+                    dependentVariablesToSaveInEnvironment, maximumDistanceRate ); } );
+    environmentPool_->acquireEnvironment( );
+}
 
 
-    //Create bodyMap and add the satellite as an empty body
-    bodyMap_ = simulation_setup::createBodies( bodySettings );
-    bodyMap_["Satellite"] = std::make_shared<Body>();
-    setGlobalFrameBodyEphemerides( bodyMap_, "Earth", "J2000" );
+std::vector<double> PropagationTargetingProblem::fitness(const std::vector<double> &x) const
+{
+    return computeFitness( x, nullptr );
 }
 
+std::vector<double> PropagationTargetingProblem::fitness(const std::vector<double> &x,
+                                                         PropagationTargetingResults& results ) const
+{
+    return computeFitness( x, &results );
+}
 
-std::vector<double> PropagationTargetingProblem::fitness(const std::vector<double> &x) const
+std::vector<double> PropagationTargetingProblem::computeFitness(const std::vector<double> &x,
+                                                                PropagationTargetingResults* results ) const
 {
     using namespace tudat;
     using namespace tudat::simulation_setup;
@@ -88,7 +255,6 @@ std::vector<double> PropagationTargetingProblem::fitness(const std::vector<doubl
     using namespace tudat::input_output;
 
     const double earthRotationRate = 2.0 * mathematical_constants::PI / physical_constants::SIDEREAL_DAY;
-    const double fixedStepSize = 30.0;
 
     //Define position of the target at 35000 km from Earth at 30 deg latitude
     Eigen::Vector3d target;
@@ -108,80 +274,77 @@ std::vector<double> PropagationTargetingProblem::fitness(const std::vector<doubl
     const Eigen::Vector6d systemInitialState = convertKeplerianToCartesianElements(
                 initialKeplerElements, earthGravitationalParameter_ );
 
-    //Setup simulation. Simple Keplerian orbit (only central-gravity of Earth)
-    std::vector< std::string > bodiesToPropagate = { "Satellite" };
-    std::vector< std::string > centralBodies = { "Earth" };
-    SelectedAccelerationMap accelerationMap;
-    std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > accelerationsOfSatellite;
-    if( useExtendedDynamics_ )
-    {
-        accelerationsOfSatellite[ "Earth" ].push_back( std::make_shared< SphericalHarmonicAccelerationSettings >(
-                                                           2, 2 ) );
-        accelerationsOfSatellite[ "Moon" ].push_back( std::make_shared< AccelerationSettings >(
-                                                          point_mass_gravity ) );
-        accelerationsOfSatellite[ "Sun" ].push_back( std::make_shared< AccelerationSettings >(
-                                                         point_mass_gravity ) );
-        accelerationMap[ "Satellite" ] = accelerationsOfSatellite;
-    }
-    else
+    // For central gravity only, the closest approach is computed in closed form, evaluated at the same epochs as the
+    // numerical propagation and refined by root-finding on the range-rate
+    if( useAnalyticKeplerPropagation_ )
     {
-        accelerationsOfSatellite[ "Earth" ].push_back( std::make_shared< AccelerationSettings >(
-                                                           point_mass_gravity ) );
-        accelerationMap[ "Satellite" ] = accelerationsOfSatellite;
+        const AnalyticKeplerOrbit keplerOrbit( initialKeplerElements, earthGravitationalParameter_, simulationStartEpoch_ );
+        double timeForBestDistanceFromTarget;
+        const double bestDistanceFromTarget = computeKeplerOrbitClosestApproach(
+                    keplerOrbit, target, earthRotationRate, simulationStartEpoch_, simulationEndEpoch_,
+                    targetingPropagationStepSize, timeForBestDistanceFromTarget );
+
+        // State and dependent variable histories are only available from a numerical propagation
+        if( results != nullptr )
+        {
+            propagateNumerically( systemInitialState, target, results );
+            results->closestApproachTime_ = timeForBestDistanceFromTarget;
+        }
+        isLastEvaluationPruned_ = false;
+
+        std::vector< double > output = {bestDistanceFromTarget} ;
+        return output;
     }
-    basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
-                bodyMap_, accelerationMap, bodiesToPropagate, centralBodies );
 
-    //Setup propagator (cowell) and integrator (RK4 fixed stepsize)
-    std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
-            std::make_shared< TranslationalStatePropagatorSettings< double > >
-            ( centralBodies, accelerationModelMap, bodiesToPropagate, systemInitialState, simulationEndEpoch_, cowell, dependentVariablesToSave_ );
-    std::shared_ptr< IntegratorSettings< > > integratorSettings =
-            std::make_shared< IntegratorSettings< > >
-            ( rungeKutta4, simulationStartEpoch_, fixedStepSize );
+    std::vector< double > output = {propagateNumerically( systemInitialState, target, results )} ;
 
-    //Start simulation
-    SingleArcDynamicsSimulator< > dynamicsSimulator(
-                bodyMap_, integratorSettings, propagatorSettings, true, false, false );
+    return output;
 
-    //Retrieve results
-    std::map< double, Eigen::VectorXd > integrationResult = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-    previousStateHistory_ = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-    previousFinalState_ = previousStateHistory_.rbegin( )->second;
-    previousDependentVariablesHistory_ = dynamicsSimulator.getDependentVariableHistory();
-    previousDependentVariablesFinalValues_ = previousDependentVariablesHistory_.rbegin()->second;
 
+}
 
-    //Find minimum distance from target
-    Eigen::Vector3d separationFromTarget =
-            Eigen::Quaterniond( Eigen::AngleAxisd(
-                                    -earthRotationRate * integrationResult.begin( )->first, Eigen::Vector3d::UnitZ( ) ) ) *
-            ( integrationResult.begin( )->second.segment( 0, 3 ) )- target;
+double PropagationTargetingProblem::propagateNumerically( const Eigen::Vector6d& systemInitialState,
+                                                          const Eigen::Vector3d& target,
+                                                          PropagationTargetingResults* results ) const
+{
+    using namespace tudat::propagators;
 
-    double bestDistanceFromTarget = separationFromTarget.norm( );
-    double timeForBestDistanceFromTarget = integrationResult.begin( )->first;
+    const double earthRotationRate = 2.0 * mathematical_constants::PI / physical_constants::SIDEREAL_DAY;
 
-    for( std::map< double, Eigen::VectorXd >::const_iterator stateIterator = integrationResult.begin( );
-         stateIterator != integrationResult.end( ); stateIterator++ )
-    {
-        separationFromTarget = Eigen::Quaterniond( Eigen::AngleAxisd(
-                                                       -earthRotationRate * stateIterator->first, Eigen::Vector3d::UnitZ( ) ) ) *
-                stateIterator->second.segment( 0, 3 ) - target;
-        const double distanceFromTarget = separationFromTarget.norm( );
+    // Retrieve environment for exclusive use in this evaluation, and propagate from new initial state
+    std::shared_ptr< PropagationTargetingEnvironment > environment = environmentPool_->acquireEnvironment( );
+    environment->closestApproachMonitor_.reset( target, earthRotationRate );
+    environment->pruningThreshold_ = ( results == nullptr ) ?
+                pruningThreshold_->load( ) : std::numeric_limits< double >::infinity( );
+    environment->isPropagationPruned_ = false;
+    environment->closestApproachMonitor_.addSample( simulationStartEpoch_, systemInitialState );
 
-        if( distanceFromTarget < bestDistanceFromTarget )
+    SingleArcDynamicsSimulator< >& dynamicsSimulator = *environment->dynamicsSimulator_;
+    dynamicsSimulator.integrateEquationsOfMotion( systemInitialState );
+
+    //Find minimum distance from target, interpolated between the propagated states (up to the termination of the
+    //propagation, if it was terminated early)
+    double timeForBestDistanceFromTarget;
+    const double bestDistanceFromTarget =
+            environment->closestApproachMonitor_.computeRefinedClosestApproach( timeForBestDistanceFromTarget );
+    isLastEvaluationPruned_ = environment->isPropagationPruned_;
+
+    //Retrieve results
+    if( results != nullptr )
+    {
+        const std::map< double, Eigen::VectorXd >& integrationResult =
+                dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+        results->stateHistory_ = integrationResult;
+        results->finalState_ = integrationResult.rbegin( )->second;
+        results->dependentVariablesHistory_ = dynamicsSimulator.getDependentVariableHistory( );
+        if( !results->dependentVariablesHistory_.empty( ) )
         {
-            bestDistanceFromTarget = distanceFromTarget;
-            timeForBestDistanceFromTarget = stateIterator->first;
+            results->dependentVariablesFinalValues_ = results->dependentVariablesHistory_.rbegin( )->second;
         }
-
+        results->closestApproachTime_ = timeForBestDistanceFromTarget;
     }
 
-    std::vector< double > output = {bestDistanceFromTarget} ;
-
-    return output;
-
-
+    return bestDistanceFromTarget;
 }
 
 
@@ -13,11 +13,92 @@
 #define TUDAT_EXAMPLE_PAGMO_PROBLEM_PROPAGATION_TARGETING_HPP
 
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
+#include <pagmo/threading.hpp>
+
+#include "analyticKeplerOrbit.h"
+#include "closestApproachMonitor.h"
+
 using namespace tudat;
 
+//! Results of a single propagation of the targeting problem, other than the fitness
+struct PropagationTargetingResults
+{
+    //! Propagated state at end of propagation
+    Eigen::VectorXd finalState_;
+
+    //! Full propagated state history
+    std::map< double, Eigen::VectorXd > stateHistory_;
+
+    //! Full dependent variable history
+    std::map< double, Eigen::VectorXd > dependentVariablesHistory_;
+
+    //! Dependent variables at end of propagation
+    Eigen::VectorXd dependentVariablesFinalValues_;
+
+    //! Epoch of closest approach to target
+    double closestApproachTime_;
+};
+
+//! Environment (bodies) and dynamics simulator with which a single propagation of the targeting problem is performed.
+/*!
+ *  Environment (bodies) and dynamics simulator with which a single propagation of the targeting problem is performed. The
+ *  acceleration models, propagator and integrator settings are created once, when the environment is created; an
+ *  evaluation of the fitness only resets the initial state of the simulator and the closest approach monitor.
+ */
+struct PropagationTargetingEnvironment
+{
+    tudat::simulation_setup::NamedBodyMap bodyMap_;
+
+    std::shared_ptr< tudat::propagators::SingleArcDynamicsSimulator< > > dynamicsSimulator_;
+
+    //! Monitor for closest approach to the target, fed during propagation
+    ClosestApproachMonitor closestApproachMonitor_;
+
+    //! Fitness above which the propagation of the current evaluation may be terminated (infinity if no pruning is used)
+    double pruningThreshold_;
+
+    //! Boolean denoting whether the propagation of the current evaluation was terminated by the pruning threshold
+    bool isPropagationPruned_;
+};
+
+//! Pool of environments for the targeting problem.
+/*!
+ *  Pool of environments for the targeting problem. Each evaluation of the fitness checks out an environment for its
+ *  exclusive use, and returns it to the pool when done, so that concurrent evaluations never share a body map. New
+ *  environments are created when all existing ones are in use, so the pool grows to the number of concurrent evaluations.
+ */
+class PropagationTargetingEnvironmentPool
+{
+public:
+
+    //! Constructor, with the function used to create a new environment
+    PropagationTargetingEnvironmentPool(
+            const std::function< std::unique_ptr< PropagationTargetingEnvironment >( ) > environmentCreationFunction ):
+        environmentCreationFunction_( environmentCreationFunction ){ }
+
+    //! Function to check out an environment, which is returned to the pool when the returned pointer is destroyed
+    std::shared_ptr< PropagationTargetingEnvironment > acquireEnvironment( );
+
+private:
+
+    //! Function to return an environment to the pool
+    void releaseEnvironment( PropagationTargetingEnvironment* environment );
+
+    std::function< std::unique_ptr< PropagationTargetingEnvironment >( ) > environmentCreationFunction_;
+
+    std::mutex poolMutex_;
+
+    std::vector< std::unique_ptr< PropagationTargetingEnvironment > > availableEnvironments_;
+};
+
 // Define the problem PaGMO-style
 struct PropagationTargetingProblem {
 
@@ -27,37 +108,54 @@ struct PropagationTargetingProblem {
     PropagationTargetingProblem( const double altitudeOfPerigee, const double altitudeOfApogee,
                                  const double altitudeOfTarget, const double longitudeOfTarget,
                                  const std::shared_ptr< propagators::DependentVariableSaveSettings > dependentVariablesToSave,
-                                 const bool useExtendedDynamics = false );
+                                 const bool useExtendedDynamics = false,
+                                 const bool useAnalyticKeplerPropagation = false );
 
     // Fitness: takes the value of the RAAN and returns the value of the closest distance from target
     std::vector<double> fitness(const std::vector<double> &x) const;
 
+    // Fitness, with full propagation results returned through the results object
+    std::vector<double> fitness(const std::vector<double> &x, PropagationTargetingResults& results ) const;
+
     // Boundaries of the problem set between 0 and (360) degrees
     std::pair<std::vector<double>, std::vector<double>> get_bounds() const;
 
-    Eigen::VectorXd getPreviousFinalState( )
+    // Set the fitness threshold above which propagations are terminated early (infinity to always propagate fully).
+    // For a propagation that is terminated early, the returned fitness is the closest approach so far, which is larger
+    // than the threshold, but may be larger than the fitness of a full propagation. The threshold is shared by all
+    // copies of the problem, so it may be updated by the optimizer driver while islands are evolving (e.g. to the
+    // fitness of the current champion). No pruning is used when propagation results are requested, or when the fitness is
+    // computed analytically.
+    void setPruningThreshold( const double pruningThreshold )
     {
-        return previousFinalState_;
+        pruningThreshold_->store( pruningThreshold );
     }
 
-    std::map< double, Eigen::VectorXd > getPreviousStateHistory( )
+    double getPruningThreshold( ) const
     {
-        return previousStateHistory_;
+        return pruningThreshold_->load( );
     }
 
-    std::map< double, Eigen::VectorXd > getPreviousDependentVariablesHistory()
+    // Check whether the most recent fitness evaluation on the calling thread was terminated early by the pruning threshold,
+    // in which case its fitness is only an upper bound on the closest approach (e.g. to exclude it from surrogate models)
+    static bool wasLastEvaluationPruned( )
     {
-        return previousDependentVariablesHistory_;
+        return isLastEvaluationPruned_;
     }
 
-    Eigen::VectorXd getPreviousDependentVariablesFinalValues()
+    // Concurrent evaluations each use their own environment (see PropagationTargetingEnvironmentPool)
+    pagmo::thread_safety get_thread_safety( ) const
     {
-        return previousDependentVariablesFinalValues_;
+        return pagmo::thread_safety::basic;
     }
 
+private:
 
+    std::vector<double> computeFitness(const std::vector<double> &x, PropagationTargetingResults* results ) const;
 
-private:
+    // Propagate numerically from the given initial state, and return the closest approach to the target
+    double propagateNumerically( const Eigen::Vector6d& systemInitialState, const Eigen::Vector3d& target,
+                                 PropagationTargetingResults* results ) const;
 
     double altitudeOfPerigee_;
     double altitudeOfApogee_;
@@ -75,15 +173,21 @@ private:
 
     bool useExtendedDynamics_;
 
-    mutable std::map< double, Eigen::VectorXd > previousStateHistory_;
-    mutable Eigen::VectorXd previousFinalState_;
-    mutable tudat::simulation_setup::NamedBodyMap bodyMap_;
-    mutable std::map< double, Eigen::VectorXd > previousDependentVariablesHistory_;
-    mutable Eigen::VectorXd previousDependentVariablesFinalValues_;
+    // Boolean denoting whether the closest approach is computed analytically (only without extended dynamics), in which
+    // case a numerical propagation is only performed when propagation results are requested
+    bool useAnalyticKeplerPropagation_;
 
+    // Upper bound on the rate of change of the distance from the target, used to bound the remaining closest approach
+    double maximumDistanceRate_;
 
+    // Fitness threshold for early termination, shared by all copies of the problem
+    std::shared_ptr< std::atomic< double > > pruningThreshold_;
 
+    // Environments used by fitness evaluations, shared by all copies of the problem
+    std::shared_ptr< PropagationTargetingEnvironmentPool > environmentPool_;
 
+    // Boolean denoting whether the most recent fitness evaluation on each thread was terminated early
+    static thread_local bool isLastEvaluationPruned_;
 };
 
 #endif // TUDAT_EXAMPLE_PAGMO_PROBLEM_PROPAGATION_TARGETING_HPP
@@ -0,0 +1,101 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/QR>
+
+#include "radialBasisFunctionSurrogate.h"
+
+//! Constructor, fits the model to the training points
+RadialBasisFunctionSurrogate::RadialBasisFunctionSurrogate(
+        const std::vector< double >& lowerBounds,
+        const std::vector< double >& upperBounds,
+        const std::vector< std::vector< double > >& trainingInputs,
+        const std::vector< double >& trainingOutputs )
+{
+    const int inputSize = lowerBounds.size( );
+    const int numberOfPoints = trainingInputs.size( );
+    if( static_cast< int >( upperBounds.size( ) ) != inputSize ||
+            static_cast< int >( trainingOutputs.size( ) ) != numberOfPoints )
+    {
+        throw std::runtime_error( "Error when creating RBF surrogate, inconsistent input sizes." );
+    }
+    if( numberOfPoints < inputSize + 1 )
+    {
+        throw std::runtime_error( "Error when creating RBF surrogate, at least " + std::to_string( inputSize + 1 ) +
+                                  " training points are required." );
+    }
+
+    lowerBounds_ = Eigen::Map< const Eigen::VectorXd >( lowerBounds.data( ), inputSize );
+    boundsRange_ = Eigen::Map< const Eigen::VectorXd >( upperBounds.data( ), inputSize ) - lowerBounds_;
+    for( int i = 0; i < inputSize; i++ )
+    {
+        if( !( boundsRange_( i ) > 0.0 ) )
+        {
+            boundsRange_( i ) = 1.0;
+        }
+    }
+
+    normalizedTrainingInputs_.resize( inputSize, numberOfPoints );
+    for( int i = 0; i < numberOfPoints; i++ )
+    {
+        normalizedTrainingInputs_.col( i ) = normalizeInput( trainingInputs.at( i ) );
+    }
+
+    // Set up interpolation system [ Phi P; P^T 0 ] [ w; c ] = [ f; 0 ]
+    const int systemSize = numberOfPoints + inputSize + 1;
+    Eigen::MatrixXd systemMatrix = Eigen::MatrixXd::Zero( systemSize, systemSize );
+    Eigen::VectorXd systemRightHandSide = Eigen::VectorXd::Zero( systemSize );
+    for( int i = 0; i < numberOfPoints; i++ )
+    {
+        for( int j = 0; j < i; j++ )
+        {
+            const double distance = ( normalizedTrainingInputs_.col( i ) - normalizedTrainingInputs_.col( j ) ).norm( );
+            systemMatrix( i, j ) = systemMatrix( j, i ) = distance * distance * distance;
+        }
+        systemMatrix( i, numberOfPoints ) = systemMatrix( numberOfPoints, i ) = 1.0;
+        systemMatrix.block( i, numberOfPoints + 1, 1, inputSize ) = normalizedTrainingInputs_.col( i ).transpose( );
+        systemMatrix.block( numberOfPoints + 1, i, inputSize, 1 ) = normalizedTrainingInputs_.col( i );
+        systemRightHandSide( i ) = trainingOutputs.at( i );
+    }
+
+    // System is symmetric, but indefinite; use rank-revealing decomposition for robustness to (nearly) coinciding points
+    Eigen::VectorXd solution = systemMatrix.colPivHouseholderQr( ).solve( systemRightHandSide );
+    kernelWeights_ = solution.segment( 0, numberOfPoints );
+    polynomialCoefficients_ = solution.segment( numberOfPoints, inputSize + 1 );
+}
+
+//! Function to compute the model value at the given input
+double RadialBasisFunctionSurrogate::predict( const std::vector< double >& input ) const
+{
+    const Eigen::VectorXd normalizedInput = normalizeInput( input );
+
+    double prediction = polynomialCoefficients_( 0 ) +
+            polynomialCoefficients_.segment( 1, normalizedInput.rows( ) ).dot( normalizedInput );
+    for( int i = 0; i < normalizedTrainingInputs_.cols( ); i++ )
+    {
+        const double distance = ( normalizedTrainingInputs_.col( i ) - normalizedInput ).norm( );
+        prediction += kernelWeights_( i ) * distance * distance * distance;
+    }
+    return prediction;
+}
+
+//! Function to normalize an input to the unit hypercube
+Eigen::VectorXd RadialBasisFunctionSurrogate::normalizeInput( const std::vector< double >& input ) const
+{
+    if( static_cast< int >( input.size( ) ) != lowerBounds_.rows( ) )
+    {
+        throw std::runtime_error( "Error when evaluating RBF surrogate, input size is inconsistent." );
+    }
+    return ( Eigen::Map< const Eigen::VectorXd >( input.data( ), input.size( ) ) - lowerBounds_ ).cwiseQuotient(
+                boundsRange_ );
+}
@@ -0,0 +1,71 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_RADIAL_BASIS_FUNCTION_SURROGATE_H
+#define TUDAT_EXAMPLE_PAGMO_RADIAL_BASIS_FUNCTION_SURROGATE_H
+
+#include <vector>
+
+#include <Eigen/Core>
+
+//! Radial basis function (RBF) interpolation model of a scalar function, used as surrogate for an expensive fitness function.
+/*!
+ *  Radial basis function (RBF) interpolation model of a scalar function, used as surrogate for an expensive fitness
+ *  function. The model uses a cubic kernel phi(r) = r^3 with a linear polynomial tail, which requires no shape parameter
+ *  and reproduces linear functions exactly. The input is normalized to the unit hypercube using the bounds of the decision
+ *  vector, so that all decision variables have comparable weight. The model interpolates the training points exactly, and
+ *  is fitted by solving a dense linear system, so the number of training points should be limited to a few hundred.
+ */
+class RadialBasisFunctionSurrogate
+{
+public:
+
+    //! Constructor, fits the model to the training points
+    /*!
+     *  Constructor, fits the model to the training points
+     *  \param lowerBounds Lower bounds of the input
+     *  \param upperBounds Upper bounds of the input
+     *  \param trainingInputs Inputs of training points (at least size of input + 1 points)
+     *  \param trainingOutputs Function values at training points
+     */
+    RadialBasisFunctionSurrogate( const std::vector< double >& lowerBounds,
+                                  const std::vector< double >& upperBounds,
+                                  const std::vector< std::vector< double > >& trainingInputs,
+                                  const std::vector< double >& trainingOutputs );
+
+    //! Function to compute the model value at the given input
+    double predict( const std::vector< double >& input ) const;
+
+    //! Function to retrieve the number of training points
+    int getNumberOfTrainingPoints( ) const
+    {
+        return normalizedTrainingInputs_.cols( );
+    }
+
+private:
+
+    //! Function to normalize an input to the unit hypercube
+    Eigen::VectorXd normalizeInput( const std::vector< double >& input ) const;
+
+    Eigen::VectorXd lowerBounds_;
+
+    Eigen::VectorXd boundsRange_;
+
+    //! Normalized inputs of training points (one column per point)
+    Eigen::MatrixXd normalizedTrainingInputs_;
+
+    //! Weights of radial basis functions (one per training point)
+    Eigen::VectorXd kernelWeights_;
+
+    //! Coefficients of linear polynomial tail (constant term first)
+    Eigen::VectorXd polynomialCoefficients_;
+};
+
+#endif // TUDAT_EXAMPLE_PAGMO_RADIAL_BASIS_FUNCTION_SURROGATE_H
@@ -0,0 +1,198 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <pagmo/utils/multi_objective.hpp>
+
+#include "surrogateAssistedProblem.h"
+
+//! Constructor
+SurrogateAssistedProblem::SurrogateAssistedProblem( const pagmo::problem& trueProblem,
+                                                    const SurrogatePreScreeningSettings& preScreeningSettings ):
+    trueProblem_( trueProblem ), preScreeningSettings_( preScreeningSettings ),
+    surrogateData_( std::make_shared< SurrogateModelData >( ) )
+{
+    if( trueProblem_.get_nc( ) > 0 )
+    {
+        throw std::runtime_error( "Error, surrogate-assisted optimization is only supported for unconstrained problems." );
+    }
+
+    // Use default number of training points, and ensure that the RBF model is well-defined
+    const unsigned int minimumNumberOfModelPoints = trueProblem_.get_nx( ) + 1;
+    if( preScreeningSettings_.minimumNumberOfTrainingPoints_ == 0 )
+    {
+        preScreeningSettings_.minimumNumberOfTrainingPoints_ = 5 * trueProblem_.get_nx( );
+    }
+    preScreeningSettings_.minimumNumberOfTrainingPoints_ =
+            std::max( preScreeningSettings_.minimumNumberOfTrainingPoints_, minimumNumberOfModelPoints );
+    preScreeningSettings_.maximumNumberOfTrainingPoints_ =
+            std::max( preScreeningSettings_.maximumNumberOfTrainingPoints_,
+                      preScreeningSettings_.minimumNumberOfTrainingPoints_ );
+    preScreeningSettings_.numberOfPointsPerRefit_ = std::max( preScreeningSettings_.numberOfPointsPerRefit_, 1u );
+}
+
+//! Fitness, from the true fitness function for promising candidates, and from the surrogate for other candidates
+pagmo::vector_double SurrogateAssistedProblem::fitness( const pagmo::vector_double& decisionVector ) const
+{
+    // Retrieve current models (fitted models are never modified, only replaced)
+    std::shared_ptr< const std::vector< RadialBasisFunctionSurrogate > > surrogateModels;
+    std::shared_ptr< const std::vector< pagmo::vector_double > > referenceFitnessVectors;
+    {
+        std::lock_guard< std::mutex > lock( surrogateData_->dataMutex_ );
+        surrogateModels = surrogateData_->surrogateModels_;
+        referenceFitnessVectors = surrogateData_->referenceFitnessVectors_;
+    }
+
+    // Pre-screen candidate, and return predicted fitness if it is not promising
+    if( surrogateModels != nullptr )
+    {
+        pagmo::vector_double predictedFitness( surrogateModels->size( ) );
+        for( unsigned int i = 0; i < surrogateModels->size( ); i++ )
+        {
+            predictedFitness.at( i ) = surrogateModels->at( i ).predict( decisionVector );
+        }
+
+        if( !isCandidatePromising( predictedFitness, *referenceFitnessVectors ) )
+        {
+            surrogateData_->numberOfSurrogateEvaluations_++;
+            return predictedFitness;
+        }
+    }
+
+    // Evaluate true fitness, and use it to improve the surrogate (if it is exact)
+    const pagmo::vector_double trueFitness = trueProblem_.fitness( decisionVector );
+    surrogateData_->numberOfTrueEvaluations_++;
+    if( !preScreeningSettings_.isTrueEvaluationInexactFunction_ ||
+            !preScreeningSettings_.isTrueEvaluationInexactFunction_( ) )
+    {
+        addTrainingPoint( decisionVector, trueFitness );
+    }
+
+    return trueFitness;
+}
+
+//! Function to check whether a candidate is promising, given its predicted fitness and the current reference fitnesses
+bool SurrogateAssistedProblem::isCandidatePromising(
+        const pagmo::vector_double& predictedFitness,
+        const std::vector< pagmo::vector_double >& referenceFitnessVectors ) const
+{
+    // Predicted fitness that is not a number cannot be screened
+    for( unsigned int i = 0; i < predictedFitness.size( ); i++ )
+    {
+        if( !std::isfinite( predictedFitness.at( i ) ) )
+        {
+            return true;
+        }
+    }
+
+    if( predictedFitness.size( ) == 1 )
+    {
+        // Compare to quantile of true fitness values
+        std::vector< double > referenceValues;
+        for( unsigned int i = 0; i < referenceFitnessVectors.size( ); i++ )
+        {
+            referenceValues.push_back( referenceFitnessVectors.at( i ).at( 0 ) );
+        }
+        const std::size_t quantileIndex = std::min(
+                    static_cast< std::size_t >( preScreeningSettings_.promisingFraction_ * referenceValues.size( ) ),
+                    referenceValues.size( ) - 1 );
+        std::nth_element( referenceValues.begin( ), referenceValues.begin( ) + quantileIndex, referenceValues.end( ) );
+        return predictedFitness.at( 0 ) <= referenceValues.at( quantileIndex );
+    }
+    else
+    {
+        // Check if predicted fitness is dominated by any true fitness vector
+        for( unsigned int i = 0; i < referenceFitnessVectors.size( ); i++ )
+        {
+            if( pagmo::pareto_dominance( referenceFitnessVectors.at( i ), predictedFitness ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+//! Function to add a true evaluation to the training set, refitting the surrogate models if required
+void SurrogateAssistedProblem::addTrainingPoint( const pagmo::vector_double& decisionVector,
+                                                 const pagmo::vector_double& fitnessVector ) const
+{
+    // Points with non-finite fitness (e.g. failed propagations) cannot be interpolated
+    for( unsigned int i = 0; i < fitnessVector.size( ); i++ )
+    {
+        if( !std::isfinite( fitnessVector.at( i ) ) )
+        {
+            return;
+        }
+    }
+
+    // Add point, and determine if model is to be refitted (by this thread)
+    std::vector< pagmo::vector_double > trainingInputs;
+    std::shared_ptr< std::vector< pagmo::vector_double > > trainingOutputs;
+    {
+        std::lock_guard< std::mutex > lock( surrogateData_->dataMutex_ );
+        surrogateData_->trainingPoints_.push_back( std::make_pair( decisionVector, fitnessVector ) );
+        if( surrogateData_->trainingPoints_.size( ) > preScreeningSettings_.maximumNumberOfTrainingPoints_ )
+        {
+            surrogateData_->trainingPoints_.pop_front( );
+        }
+        surrogateData_->numberOfPointsSinceFit_++;
+
+        const bool isFirstFitDue = ( surrogateData_->surrogateModels_ == nullptr ) &&
+                ( surrogateData_->trainingPoints_.size( ) >= preScreeningSettings_.minimumNumberOfTrainingPoints_ );
+        const bool isRefitDue = ( surrogateData_->surrogateModels_ != nullptr ) &&
+                ( surrogateData_->numberOfPointsSinceFit_ >= preScreeningSettings_.numberOfPointsPerRefit_ );
+        if( surrogateData_->isFitInProgress_ || !( isFirstFitDue || isRefitDue ) )
+        {
+            return;
+        }
+
+        surrogateData_->isFitInProgress_ = true;
+        surrogateData_->numberOfPointsSinceFit_ = 0;
+        trainingOutputs = std::make_shared< std::vector< pagmo::vector_double > >( );
+        for( auto pointIterator : surrogateData_->trainingPoints_ )
+        {
+            trainingInputs.push_back( pointIterator.first );
+            trainingOutputs->push_back( pointIterator.second );
+        }
+    }
+
+    // Fit models outside of lock, so that other evaluations continue with the previous models
+    std::shared_ptr< std::vector< RadialBasisFunctionSurrogate > > surrogateModels;
+    try
+    {
+        const std::pair< pagmo::vector_double, pagmo::vector_double > bounds = trueProblem_.get_bounds( );
+        surrogateModels = std::make_shared< std::vector< RadialBasisFunctionSurrogate > >( );
+        for( unsigned int i = 0; i < fitnessVector.size( ); i++ )
+        {
+            std::vector< double > objectiveValues;
+            for( unsigned int j = 0; j < trainingOutputs->size( ); j++ )
+            {
+                objectiveValues.push_back( trainingOutputs->at( j ).at( i ) );
+            }
+            surrogateModels->push_back(
+                        RadialBasisFunctionSurrogate( bounds.first, bounds.second, trainingInputs, objectiveValues ) );
+        }
+    }
+    catch( ... )
+    {
+        std::lock_guard< std::mutex > lock( surrogateData_->dataMutex_ );
+        surrogateData_->isFitInProgress_ = false;
+        throw;
+    }
+
+    std::lock_guard< std::mutex > lock( surrogateData_->dataMutex_ );
+    surrogateData_->surrogateModels_ = surrogateModels;
+    surrogateData_->referenceFitnessVectors_ = trainingOutputs;
+    surrogateData_->isFitInProgress_ = false;
+}
@@ -0,0 +1,182 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_EXAMPLE_PAGMO_SURROGATE_ASSISTED_PROBLEM_H
+#define TUDAT_EXAMPLE_PAGMO_SURROGATE_ASSISTED_PROBLEM_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pagmo/problem.hpp>
+#include <pagmo/threading.hpp>
+#include <pagmo/types.hpp>
+
+#include "radialBasisFunctionSurrogate.h"
+
+//! Settings for the pre-screening of a SurrogateAssistedProblem
+struct SurrogatePreScreeningSettings
+{
+    SurrogatePreScreeningSettings( const double promisingFraction = 0.15,
+                                   const unsigned int minimumNumberOfTrainingPoints = 0,
+                                   const unsigned int maximumNumberOfTrainingPoints = 200,
+                                   const unsigned int numberOfPointsPerRefit = 10 ):
+        promisingFraction_( promisingFraction ), minimumNumberOfTrainingPoints_( minimumNumberOfTrainingPoints ),
+        maximumNumberOfTrainingPoints_( maximumNumberOfTrainingPoints ), numberOfPointsPerRefit_( numberOfPointsPerRefit ){ }
+
+    //! Fraction of the true fitness values in the training set below which a predicted (single-objective) fitness must be
+    //! for the candidate to be evaluated with the true fitness function
+    double promisingFraction_;
+
+    //! Number of true evaluations before the surrogate is used (0 for 5 times the number of decision variables)
+    unsigned int minimumNumberOfTrainingPoints_;
+
+    //! Maximum number of (most recent) true evaluations used to fit the surrogate
+    unsigned int maximumNumberOfTrainingPoints_;
+
+    //! Number of new true evaluations after which the surrogate is refitted
+    unsigned int numberOfPointsPerRefit_;
+
+    //! Function called on the evaluating thread directly after each true evaluation, returning true if the fitness it
+    //! returned is not exact (e.g. a propagation that was terminated early), in which case the evaluation is not added to
+    //! the training set. If empty, all true evaluations are considered exact.
+    std::function< bool( ) > isTrueEvaluationInexactFunction_;
+};
+
+//! Surrogate model data shared by all copies of a SurrogateAssistedProblem
+struct SurrogateModelData
+{
+    SurrogateModelData( ): numberOfPointsSinceFit_( 0 ), isFitInProgress_( false ),
+        numberOfTrueEvaluations_( 0 ), numberOfSurrogateEvaluations_( 0 ){ }
+
+    std::mutex dataMutex_;
+
+    //! Most recent true evaluations (decision vector, fitness vector), oldest first
+    std::deque< std::pair< pagmo::vector_double, pagmo::vector_double > > trainingPoints_;
+
+    //! Surrogate models (one per objective) fitted to the training points, empty if not yet fitted
+    std::shared_ptr< const std::vector< RadialBasisFunctionSurrogate > > surrogateModels_;
+
+    //! Training points from which surrogateModels_ was fitted, used as reference for pre-screening
+    std::shared_ptr< const std::vector< pagmo::vector_double > > referenceFitnessVectors_;
+
+    unsigned int numberOfPointsSinceFit_;
+
+    bool isFitInProgress_;
+
+    std::atomic< unsigned long long > numberOfTrueEvaluations_;
+
+    std::atomic< unsigned long long > numberOfSurrogateEvaluations_;
+};
+
+//! Problem wrapper that pre-screens candidates with a surrogate model, so that only promising candidates are evaluated with
+//! the (expensive) fitness function of the wrapped problem.
+/*!
+ *  Problem wrapper that pre-screens candidates with a surrogate model, so that only promising candidates are evaluated with
+ *  the (expensive) fitness function of the wrapped problem, e.g. a problem that requires a numerical propagation for each
+ *  fitness evaluation. A radial basis function model (see RadialBasisFunctionSurrogate) is fitted to each objective, using
+ *  the most recent true evaluations, and refitted periodically as new true evaluations become available. Until enough
+ *  true evaluations are available, all candidates are evaluated with the true fitness function.
+ *
+ *  A candidate is considered promising if (for a single objective) its predicted fitness is below the given quantile
+ *  (promisingFraction_) of the true fitness values in the training set, or (for multiple objectives) its predicted fitness
+ *  vector is not dominated by any of the true fitness vectors in the training set. Promising candidates are evaluated with
+ *  the true fitness function, and added to the training set. For all other candidates, the predicted fitness is returned,
+ *  which is (by construction) worse than that of the promising part of the population, so that these candidates are
+ *  typically discarded by the optimizer. As a result, the fitness values in a population are a mix of true and predicted
+ *  values; the best individuals will typically have been evaluated with the true fitness function.
+ *
+ *  The training set and models are shared by all copies of the problem (e.g. all islands of an archipelago), so that all
+ *  true evaluations are used to improve the model. Only unconstrained problems are supported.
+ */
+class SurrogateAssistedProblem
+{
+public:
+
+    //! Empty constructor
+    SurrogateAssistedProblem( ): surrogateData_( std::make_shared< SurrogateModelData >( ) ){ }
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param trueProblem Problem with expensive fitness function
+     *  \param preScreeningSettings Settings for the pre-screening of candidates
+     */
+    SurrogateAssistedProblem( const pagmo::problem& trueProblem,
+                              const SurrogatePreScreeningSettings& preScreeningSettings = SurrogatePreScreeningSettings( ) );
+
+    //! Fitness, from the true fitness function for promising candidates, and from the surrogate for other candidates
+    pagmo::vector_double fitness( const pagmo::vector_double& decisionVector ) const;
+
+    //! Boundaries of the problem (identical to wrapped problem)
+    std::pair< pagmo::vector_double, pagmo::vector_double > get_bounds( ) const
+    {
+        return trueProblem_.get_bounds( );
+    }
+
+    //! Number of objectives (identical to wrapped problem)
+    pagmo::vector_double::size_type get_nobj( ) const
+    {
+        return trueProblem_.get_nobj( );
+    }
+
+    std::string get_name( ) const
+    {
+        return "Surrogate-assisted " + trueProblem_.get_name( );
+    }
+
+    //! Thread safety of wrapped problem (at most basic, since the surrogate data is synchronized)
+    pagmo::thread_safety get_thread_safety( ) const
+    {
+        return ( trueProblem_.get_thread_safety( ) == pagmo::thread_safety::none ) ?
+                    pagmo::thread_safety::none : pagmo::thread_safety::basic;
+    }
+
+    //! Function to retrieve the total number of evaluations of the true fitness function (over all copies of the problem)
+    unsigned long long getNumberOfTrueEvaluations( ) const
+    {
+        return surrogateData_->numberOfTrueEvaluations_;
+    }
+
+    //! Function to retrieve the total number of candidates for which the surrogate fitness was returned
+    unsigned long long getNumberOfSurrogateEvaluations( ) const
+    {
+        return surrogateData_->numberOfSurrogateEvaluations_;
+    }
+
+    //! Function to retrieve the wrapped problem
+    const pagmo::problem& getTrueProblem( ) const
+    {
+        return trueProblem_;
+    }
+
+private:
+
+    //! Function to check whether a candidate is promising, given its predicted fitness and the current reference fitnesses
+    bool isCandidatePromising( const pagmo::vector_double& predictedFitness,
+                               const std::vector< pagmo::vector_double >& referenceFitnessVectors ) const;
+
+    //! Function to add a true evaluation to the training set, refitting the surrogate models if required
+    void addTrainingPoint( const pagmo::vector_double& decisionVector, const pagmo::vector_double& fitnessVector ) const;
+
+    pagmo::problem trueProblem_;
+
+    SurrogatePreScreeningSettings preScreeningSettings_;
+
+    //! Training set and surrogate models, shared by all copies of the problem
+    std::shared_ptr< SurrogateModelData > surrogateData_;
+};
+
+#endif // TUDAT_EXAMPLE_PAGMO_SURROGATE_ASSISTED_PROBLEM_H
@@ -3,16 +3,18 @@
 #include <boost/filesystem.hpp>
 
 #include "pagmo/problems/cec2013.hpp"
-#include "pagmo/island.hpp"
 #include "pagmo/problem.hpp"
 
 #include "Problems/himmelblau.h"
 #include "Problems/getAlgorithm.h"
 #include "Problems/saveOptimizationResults.h"
 #include "Problems/applicationOutput.h"
+#include "Problems/benchmarkHarness.h"
 
 int main( )
 {
+    using namespace tudat_pagmo_applications;
+
     // Set random seed
     pagmo::random_device::set_seed( 12345 );
 
@@ -21,101 +23,107 @@ int main( )
     unsigned int numberOfOptimizers = 11;
     unsigned int numberOfProblems = 28;
     unsigned int numberOfPopulationCases = 3;
+    unsigned int numberOfSeeds = 5;
 
-    // Create double vector of Matrices that contain optimal solutions
-    std::vector< std::vector< Eigen::MatrixXd > > optima;
-    optima.resize( numberOfDimensionCases );
-    for( unsigned int i = 0; i < numberOfDimensionCases; i++ )
+    std::vector< unsigned int > numberOfDimensionsPerCase = { 2, 5, 10 };
+    std::vector< unsigned int > populationSizePerCase = { 16, 32, 64 };
+    std::vector< unsigned int > numberOfGenerationsPerCase = { 64, 32, 16 };
+
+    // Identify each optimizer by its name and settings, so that results stored for other settings are recomputed (change
+    // the run tag to force all cases to be recomputed)
+    const std::string runTag = "";
+    std::vector< std::string > algorithmConfigurations;
+    for( unsigned int i = 0; i < numberOfOptimizers; i++ )
     {
-        optima[ i ].resize( numberOfPopulationCases );
-        for( unsigned int j = 0; j < numberOfPopulationCases; j++ )
-        {
-            optima[ i ][ j ] = Eigen::MatrixXd( numberOfProblems, numberOfOptimizers );
-        }
+        algorithmConfigurations.push_back( getAlgorithmConfigurationIdentifier(
+                                               getSingleObjectiveAlgorithmNames( ).at( i ), getAlgorithm( i ), runTag ) );
     }
 
-    // Perform optimization for each optimizer
+    // Create list of all benchmark cases (optimizer, test problem, dimensionality, population size/number of generations,
+    // random seed)
+    std::vector< BenchmarkCase > benchmarkCases;
     for( unsigned int i = 0; i < numberOfOptimizers; i++ )
     {
-        // Perform optimization for each test problem
         for( unsigned int j = 0; j < numberOfProblems; j++ )
         {
-            // Perform optimization for each dimensionality
             for( unsigned int k = 0; k < numberOfDimensionCases; k++ )
             {
-                int numberOfDimensions = 0;
-                if( k == 0 )
-                {
-                    numberOfDimensions = 2;
-                }
-                else if( k == 1 )
-                {
-                    numberOfDimensions = 5;
-                }
-                else if( k == 2 )
-                {
-                    numberOfDimensions = 10;
-                }
-
-                // Perform optimization for each population size/number of generations
                 for( unsigned int l = 0; l < numberOfPopulationCases; l++ )
                 {
-                    pagmo::population::size_type populationSize = 0;
-                    int numberOfGenerations = 0;
-                    if( l == 0 )
-                    {
-                        populationSize = 16;
-                        numberOfGenerations = 64;
-                    }
-                    else if( l == 1 )
+                    for( unsigned int m = 0; m < numberOfSeeds; m++ )
                     {
-                        populationSize = 32;
-                        numberOfGenerations = 32;
+                        benchmarkCases.push_back(
+                                    BenchmarkCase( i, j, numberOfDimensionsPerCase.at( k ), populationSizePerCase.at( l ),
+                                                   numberOfGenerationsPerCase.at( l ), 12345 + m,
+                                                   algorithmConfigurations.at( i ) ) );
                     }
-                    else if( l == 2 )
-                    {
-                        populationSize = 64;
-                        numberOfGenerations = 16;
-                    }
-
-                    // Create test problem
-                    pagmo::problem prob{ pagmo::cec2013( j + 1, numberOfDimensions ) };
-
-                    // Create optimization algorithm
-                    pagmo::algorithm algo = getAlgorithm( i );
+                }
+            }
+        }
+    }
 
-                    // Create island with given population size
-                    pagmo::island isl = pagmo::island{ algo, prob, populationSize };
+    // Run all cases that are not yet in the results file, in parallel. An interrupted run is resumed by restarting the
+    // application, and cases may be added (e.g. more seeds) without recomputing existing ones.
+    BenchmarkResultStore resultStore( getOutputPath( ) + "cec2013Results.txt" );
+    runBenchmark(
+                benchmarkCases,
+                [ ]( const BenchmarkCase& benchmarkCase )
+    {
+        return pagmo::problem{ pagmo::cec2013( benchmarkCase.problemIndex_ + 1, benchmarkCase.numberOfDimensions_ ) };
+    },
+    [ ]( const BenchmarkCase& benchmarkCase )
+    {
+        return getAlgorithm( benchmarkCase.algorithmIndex_ );
+    }, resultStore );
 
-                    // Evolve for required number of generations
-                    for( int j = 1; j <= numberOfGenerations; j++ )
-                    {
-                        isl.evolve( );
-                        while( isl.status( ) != pagmo::evolve_status::idle &&
-                               isl.status( ) != pagmo::evolve_status::idle_error )
-                        {
-                            isl.wait( );
-                        }
-                        isl.wait_check( ); // Raises errors
-                    }
+    // Create double vector of Matrices that contain statistics of optimal solutions over all seeds
+    std::vector< std::vector< Eigen::MatrixXd > > optima, optimaStandardDeviation, optimaMinimum, optimaMaximum;
+    optima.resize( numberOfDimensionCases );
+    optimaStandardDeviation.resize( numberOfDimensionCases );
+    optimaMinimum.resize( numberOfDimensionCases );
+    optimaMaximum.resize( numberOfDimensionCases );
+    for( unsigned int k = 0; k < numberOfDimensionCases; k++ )
+    {
+        for( unsigned int l = 0; l < numberOfPopulationCases; l++ )
+        {
+            optima[ k ].push_back( Eigen::MatrixXd( numberOfProblems, numberOfOptimizers ) );
+            optimaStandardDeviation[ k ].push_back( Eigen::MatrixXd( numberOfProblems, numberOfOptimizers ) );
+            optimaMinimum[ k ].push_back( Eigen::MatrixXd( numberOfProblems, numberOfOptimizers ) );
+            optimaMaximum[ k ].push_back( Eigen::MatrixXd( numberOfProblems, numberOfOptimizers ) );
 
-                    // Save optimal results for current optimization.
-                    optima[ k ][ l ]( j, i ) = isl.get_population().champion_f()[0];
-                    std::cout << "Minimum: " << i<<" "<<" "<<j<<" "<<isl.get_population().champion_f()[0] << std::endl;
+            for( unsigned int i = 0; i < numberOfOptimizers; i++ )
+            {
+                for( unsigned int j = 0; j < numberOfProblems; j++ )
+                {
+                    BenchmarkStatistics statistics = computeBenchmarkStatistics(
+                                resultStore.getResultsOverSeeds(
+                                    BenchmarkCase( i, j, numberOfDimensionsPerCase.at( k ), populationSizePerCase.at( l ),
+                                                   numberOfGenerationsPerCase.at( l ), 0,
+                                                   algorithmConfigurations.at( i ) ) ) );
+                    optima[ k ][ l ]( j, i ) = statistics.mean_;
+                    optimaStandardDeviation[ k ][ l ]( j, i ) = statistics.standardDeviation_;
+                    optimaMinimum[ k ][ l ]( j, i ) = statistics.minimum_;
+                    optimaMaximum[ k ][ l ]( j, i ) = statistics.maximum_;
                 }
             }
-            std::cout<<std::endl;
         }
     }
 
-    // Write all results to files.
+    // Write all results to files (mean over seeds in cec2013Optima files).
     for( unsigned int i = 0; i < numberOfDimensionCases; i++ )
     {
         for( unsigned int j = 0; j < numberOfPopulationCases; j++ )
         {
-            tudat::input_output::writeMatrixToFile( optima[ i ][ j ], "cec2013Optima_" + std::to_string( i ) + "_" +
-                                                    std::to_string( j ) + ".dat", 16,
-                                                    tudat_pagmo_applications::getOutputPath( ) );
+            std::string fileSuffix = "_" + std::to_string( i ) + "_" + std::to_string( j ) + ".dat";
+            tudat::input_output::writeMatrixToFile( optima[ i ][ j ], "cec2013Optima" + fileSuffix, 16,
+                                                    getOutputPath( ) );
+            tudat::input_output::writeMatrixToFile( optimaStandardDeviation[ i ][ j ],
+                                                    "cec2013OptimaStandardDeviation" + fileSuffix, 16,
+                                                    getOutputPath( ) );
+            tudat::input_output::writeMatrixToFile( optimaMinimum[ i ][ j ], "cec2013OptimaMinimum" + fileSuffix, 16,
+                                                    getOutputPath( ) );
+            tudat::input_output::writeMatrixToFile( optimaMaximum[ i ][ j ], "cec2013OptimaMaximum" + fileSuffix, 16,
+                                                    getOutputPath( ) );
         }
     }
 
@@ -20,6 +20,9 @@
 
 #include "Problems/earthMarsTransfer.h"
 #include "Problems/applicationOutput.h"
+#include "Problems/archipelagoDriver.h"
+#include "Problems/asynchronousOutput.h"
+#include "Problems/populationSnapshot.h"
 #include "Problems/getAlgorithm.h"
 #include "Problems/saveOptimizationResults.h"
 
@@ -44,8 +47,22 @@ int main( )
     // Create object to compute the problem fitness
     problem prob{EarthMarsTransfer( bounds )};
 
-    // Perform grid saerch
-    createGridSearch( prob, bounds, { 1000, 1000 }, "porkchopEarthMars" );
+    // Perform grid saerch, using all available threads
+    createGridSearch( prob, bounds, { 1000, 1000 }, "porkchopEarthMars",
+                      [ ]( const std::size_t numberOfEvaluatedPoints, const std::size_t totalNumberOfPoints )
+    {
+        std::cout<<"Grid search "<<numberOfEvaluatedPoints<<" / "<<totalNumberOfPoints<<std::endl;
+    } );
+
+    // Perform adaptive grid search: start from 50x50 cells, and refine (up to 16x16 subcells) only cells with a
+    // Delta V below 10 km/s, or a Delta V variation over the cell of more than 2 km/s
+    createAdaptiveGridSearch( prob, bounds, AdaptiveGridSearchSettings( { 50, 50 }, 4, 10.0E3, 2.0E3 ),
+                              "porkchopEarthMarsAdaptive",
+                              [ ]( const std::size_t numberOfEvaluatedPoints, const std::size_t totalNumberOfPoints )
+    {
+        std::cout<<"Adaptive grid search "<<numberOfEvaluatedPoints<<" points evaluated, uniform grid would require "
+                <<totalNumberOfPoints<<std::endl;
+    } );
 
     // Perform optimization with 8 different optimizers
     for( int j = 0; j < 8; j++ )
@@ -54,26 +71,25 @@ int main( )
         int algorithmIndex = j;
         algorithm algo{getAlgorithm( algorithmIndex )};
 
-        // Create an island with 1024 individuals
-        island isl{algo, prob, 1024};
-
-        // Evolve for 100 generations
-        for( int i = 0 ; i < 100; i++ )
+        // Create an archipelago of 8 islands with 128 individuals each (1024 individuals in total)
+        const unsigned int numberOfIslands = 8;
+        pagmo::archipelago archi = createArchipelago( algo, prob, numberOfIslands, 128 );
+
+        // Evolve for 100 generations, writing results to (binary) file after each generation
+        PopulationSnapshotWriter snapshotWriter(
+                    getOutputPath( ) + "populationSnapshots_earthMarsLambert_" + std::to_string( j ) + ".bin",
+                    numberOfIslands * 128, prob.get_nx( ), prob.get_nf( ) );
+        AsynchronousOutputQueue< PopulationSnapshot > snapshotOutput(
+                    [ & ]( PopulationSnapshot& snapshot ){ snapshotWriter.writeSnapshot( snapshot ); } );
+        evolveArchipelago( archi, 100, 1, [ & ]( const pagmo::archipelago& currentArchipelago, const unsigned int i )
         {
-            isl.evolve( );
-            while( isl.status( ) != pagmo::evolve_status::idle &&
-                   isl.status( ) != pagmo::evolve_status::idle_error )
-            {
-                isl.wait( );
-            }
-            isl.wait_check( ); // Raises errors
-
             // Write current iteration results to file
-            printPopulationToFile( isl.get_population( ).get_x( ), "earthMarsLambert_" + std::to_string( j ) + "_" + std::to_string( i ) , false );
-            printPopulationToFile( isl.get_population( ).get_f( ), "earthMarsLambert_" + std::to_string( j ) + "_" + std::to_string( i ) , true );
+            snapshotOutput.addOutput( PopulationSnapshot(
+                                       i - 1, getArchipelagoDecisionVectors( currentArchipelago ), getArchipelagoFitnessVectors( currentArchipelago ) ) );
 
-            std::cout<<i<<" "<<algorithmIndex<<std::endl;
-        }
+            std::cout<<i - 1<<" "<<algorithmIndex<<std::endl;
+        } );
+        snapshotOutput.waitForCompletion( );
     }
 
     return 0;
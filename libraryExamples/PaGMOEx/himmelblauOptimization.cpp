@@ -4,10 +4,12 @@
 #include "pagmo/algorithms/de.hpp"
 #include "pagmo/algorithms/sga.hpp"
 #include "pagmo/algorithms/sade.hpp"
-#include "pagmo/island.hpp"
 #include "pagmo/problem.hpp"
 #include "Problems/himmelblau.h"
 #include "Problems/applicationOutput.h"
+#include "Problems/archipelagoDriver.h"
+#include "Problems/asynchronousOutput.h"
+#include "Problems/populationSnapshot.h"
 #include "Problems/saveOptimizationResults.h"
 
 int main( )
@@ -26,28 +28,26 @@ int main( )
     // Solve using DE algorithm
     pagmo::algorithm algo{ pagmo::de( ) };
 
-    // Create island with 1000 individuals
-    pagmo::island isl = pagmo::island{ algo, prob, 1000 };
+    // Create archipelago of 8 islands with 125 individuals each (1000 individuals in total)
+    const unsigned int numberOfIslands = 8;
+    pagmo::archipelago archi = createArchipelago( algo, prob, numberOfIslands, 125 );
 
-    // Evolve for 1000 generations
-    for( int i = 1; i <= 100; i++ )
+    // Evolve for 100 generations, writing results to (binary) file after each generation
+    PopulationSnapshotWriter snapshotWriter(
+                getOutputPath( ) + "populationSnapshots_himmelblau.bin", numberOfIslands * 125, prob.get_nx( ), prob.get_nf( ) );
+    AsynchronousOutputQueue< PopulationSnapshot > snapshotOutput(
+                [ & ]( PopulationSnapshot& snapshot ){ snapshotWriter.writeSnapshot( snapshot ); } );
+    evolveArchipelago( archi, 100, 1, [ & ]( const pagmo::archipelago& currentArchipelago, const unsigned int i )
     {
-        isl.evolve( );
-        while( isl.status( ) != pagmo::evolve_status::idle &&
-               isl.status( ) != pagmo::evolve_status::idle_error )
-        {
-            isl.wait( );
-        }
-        isl.wait_check( ); // Raises errors
-
-        printPopulationToFile( isl.get_population( ).get_x( ), "himmelblau_" + std::to_string( i ) , false );
-        printPopulationToFile( isl.get_population( ).get_f( ), "himmelblau_" +  std::to_string( i ) , true );
+        snapshotOutput.addOutput( PopulationSnapshot(
+                                   i, getArchipelagoDecisionVectors( currentArchipelago ), getArchipelagoFitnessVectors( currentArchipelago ) ) );
 
         // Print current optimum to console
-        std::cout << "Minimum: " <<i<<" "<<std::setprecision( 16 ) <<"f= "<< isl.get_population().champion_f()[0] <<", x="<<
-                     isl.get_population().champion_x()[0] <<" y="<<isl.get_population().champion_x()[1] <<std::endl;
-
-    }
+        const std::pair< pagmo::vector_double, pagmo::vector_double > champion = getArchipelagoChampion( currentArchipelago );
+        std::cout << "Minimum: " <<i<<" "<<std::setprecision( 16 ) <<"f= "<< champion.second[0] <<", x="<<
+                     champion.first[0] <<" y="<<champion.first[1] <<std::endl;
+    } );
+    snapshotOutput.waitForCompletion( );
 
 
     return 0;
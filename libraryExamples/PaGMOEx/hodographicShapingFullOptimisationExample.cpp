@@ -14,8 +14,10 @@
 
 #include <boost/filesystem.hpp>
 #include "Problems/applicationOutput.h"
+#include "Problems/archipelagoDriver.h"
 #include "Problems/getAlgorithm.h"
 #include "Problems/saveOptimizationResults.h"
+#include "Problems/surrogateAssistedProblem.h"
 
 #include "Tudat/SimulationSetup/tudatSimulationHeader.h"
 #include "Tudat/Astrodynamics/LowThrustTrajectories/lowThrustOptimisationSetup.h"
@@ -104,6 +106,10 @@ int main( )
     //Set seed for reproducible results
     pagmo::random_device::set_seed( 123 );
 
+    // Set whether to pre-screen candidates with a surrogate model, so that only the most promising ones are evaluated with
+    // the shaping method (the fitness values in the population are then a mix of true and predicted values)
+    const bool useSurrogatePreScreening = false;
+
     tudat::spice_interface::loadStandardSpiceKernels( );
 
     // Ephemeris functions of bodies.
@@ -154,6 +160,10 @@ int main( )
                             departureStateFunction, arrivalStateFunction, spice_interface::getBodyGravitationalParameter( "Sun" ),
                             revolutions, std::bind( &getShapingBasisFunctions, std::placeholders::_1, revolutions ), bounds,
                             useMultiObjective, 2000.0 ) };
+            if( useSurrogatePreScreening )
+            {
+                prob = problem{ SurrogateAssistedProblem( prob ) };
+            }
 
             //sade, gaco, sga, de
             algorithm algo;
@@ -166,45 +176,52 @@ int main( )
                 algo = algorithm{ nsga2( ) };
             }
 
-            // Create an island with 1000 individuals
-            island isl{algo, prob, 2000 };
+            // Create an archipelago of 10 islands with 200 individuals each (2000 individuals in total)
+            pagmo::archipelago archi = tudat_pagmo_applications::createArchipelago( algo, prob, 10, 200 );
 
-            // Evolve for 512 generations
-            for( int i = 0 ; i < 101; i++ )
+            // Write results to file every 25 generations (and for initial population)
+            tudat_pagmo_applications::ArchipelagoOutputFunction outputFunction =
+                    [ = ]( const pagmo::archipelago& currentArchipelago, const unsigned int i )
             {
-                isl.evolve( );
-                while( isl.status( ) != pagmo::evolve_status::idle &&
-                       isl.status( ) != pagmo::evolve_status::idle_error )
+                if( !useMultiObjective )
                 {
-                    isl.wait( );
-                }
+                    std::cout<<"Iteration: "<<" "<<i<<"; Best Delta V: "<<
+                               tudat_pagmo_applications::getArchipelagoChampion( currentArchipelago ).second.at( 0 )<<std::endl;
 
-                if( i % 25 == 0 )
+                    printPopulationToFile( tudat_pagmo_applications::getArchipelagoDecisionVectors( currentArchipelago ),
+                                           "hodograph_single_objective_" + std::to_string( i / 25 ), false );
+                    printPopulationToFile( tudat_pagmo_applications::getArchipelagoFitnessVectors( currentArchipelago ),
+                                           "hodograph_single_objective_" + std::to_string( i / 25 ), true );
+                }
+                else
                 {
-                    if( !useMultiObjective )
-                    {
-                        std::cout<<"Iteration: "<<" "<<i<<"; Best Delta V: "<<isl.get_population( ).champion_f( ).at( 0 )<<std::endl;
-
-                        printPopulationToFile( isl.get_population( ).get_x( ), "hodograph_single_objective_" + std::to_string( i / 25 ), false );
-                        printPopulationToFile( isl.get_population( ).get_f( ), "hodograph_single_objective_" + std::to_string( i / 25 ), true );
-                    }
-                    else
-                    {
-                        std::cout<<"Iteration: "<<" "<<i<<std::endl;
-
-                        printPopulationToFile( isl.get_population( ).get_x( ), "hodograph_multi_objective_" + std::to_string( i / 25 ), false );
-                        printPopulationToFile( isl.get_population( ).get_f( ), "hodograph_multi_objective_" + std::to_string( i / 25 ), true );
-                    }
+                    std::cout<<"Iteration: "<<" "<<i<<std::endl;
+
+                    printPopulationToFile( tudat_pagmo_applications::getArchipelagoDecisionVectors( currentArchipelago ),
+                                           "hodograph_multi_objective_" + std::to_string( i / 25 ), false );
+                    printPopulationToFile( tudat_pagmo_applications::getArchipelagoFitnessVectors( currentArchipelago ),
+                                           "hodograph_multi_objective_" + std::to_string( i / 25 ), true );
                 }
+            };
+            outputFunction( archi, 0 );
 
+            // Evolve for 100 generations
+            tudat_pagmo_applications::evolveArchipelago( archi, 100, 25, outputFunction );
+            if( useSurrogatePreScreening )
+            {
+                const SurrogateAssistedProblem* surrogateAssistedProblem = prob.extract< SurrogateAssistedProblem >( );
+                std::cout<<"True fitness evaluations: "<<surrogateAssistedProblem->getNumberOfTrueEvaluations( )
+                        <<"; pre-screened by surrogate: "<<surrogateAssistedProblem->getNumberOfSurrogateEvaluations( )
+                       <<std::endl;
             }
 
-
             if( !useMultiObjective )
             {
-                std::cout<<"Final best Delta V: "<<isl.get_population( ).champion_f( ).at( 0 )<<std::endl;
+                const std::pair< pagmo::vector_double, pagmo::vector_double > champion =
+                        tudat_pagmo_applications::getArchipelagoChampion( archi );
+                std::cout<<"Final best Delta V: "<<champion.second.at( 0 )<<std::endl;
 
-                std::vector< double > bestPopulation = isl.get_population( ).champion_x( );
+                std::vector< double > bestPopulation = champion.first;
 
                 Eigen::VectorXd radialFreeParameters = Eigen::VectorXd::Zero( 2 );
                 Eigen::VectorXd normalFreeParameters = Eigen::VectorXd::Zero( 0 );
@@ -228,18 +228,9 @@ int main( )
             // Create an island with 1024 individuals
             island isl{ algo, prob, 25 };
 
-            // Evolve for 100 generations
-            for( int i = 0 ; i < 10; i++ )
-            {
-                isl.evolve( );
-                while( isl.status( ) != pagmo::evolve_status::idle &&
-                       isl.status( ) != pagmo::evolve_status::idle_error )
-                {
-                    isl.wait( );
-                }
-                isl.wait_check( ); // Raises errors
-
-            }
+            // Evolve for 10 generations, without intermediate synchronization
+            isl.evolve( 10 );
+            isl.wait_check( ); // Raises errors
 
             // Save high-order shaping solution.
             double currentBestDeltaV = isl.get_population( ).champion_f( )[ 0 ];
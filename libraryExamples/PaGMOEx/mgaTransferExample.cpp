@@ -20,14 +20,21 @@
 #include "pagmo/algorithms/de.hpp"
 #include "pagmo/algorithms/nsga2.hpp"
 
-#include "Problems/multipleGravityAssist.h"
+#include "Problems/fixedSequenceMultipleGravityAssist.h"
 #include "Problems/applicationOutput.h"
+#include "Problems/archipelagoDriver.h"
+#include "Problems/asynchronousOutput.h"
+#include "Problems/populationSnapshot.h"
 #include "Problems/getAlgorithm.h"
 #include "Problems/saveOptimizationResults.h"
 
+using namespace pagmo;
+
 //! Execute  main
 int main( )
 {
+    using namespace tudat_pagmo_applications;
+
     //Set seed for reproducible results
     pagmo::random_device::set_seed( 123456789 );
 
@@ -48,41 +55,33 @@ int main( )
     bounds[ 0 ][ 4 ] = 500;
     bounds[ 1 ][ 4 ] = 3000;
 
-    // Define the problem: EVEEJ flyby sequence
-    std::vector< int > flybySequence;
-    flybySequence.push_back( 3 );
-    flybySequence.push_back( 2 );
-    flybySequence.push_back( 3 );
-    flybySequence.push_back( 3 );
-    flybySequence.push_back( 5 );
-
-    // Create object to compute the problem fitness
-    problem prob{ MultipleGravityAssist( bounds, flybySequence, true ) };
+    // Define the problem: EVEEJ flyby sequence, fixed at compile time. Epochs are rounded to 0.01 days, so that Lambert arcs
+    // are reused by the (clustered) individuals in later generations
+    problem prob{ EveejMultipleGravityAssist( bounds, true, 0.01 ) };
 
     // Select NSGA2 algorithm for priblem
     algorithm algo{nsga2( )};
 
-    // Create an island with 1000 individuals
-    island isl{algo, prob, 1000 };
+    // Create an archipelago of 10 islands with 100 individuals each (1000 individuals in total)
+    const unsigned int numberOfIslands = 10;
+    pagmo::archipelago archi = createArchipelago( algo, prob, numberOfIslands, 100 );
 
-    // Evolve for 512 generations
-    for( int i = 0 ; i < 512; i++ )
+    // Evolve for 512 generations, writing results to (binary) file after each generation
+    PopulationSnapshotWriter snapshotWriter(
+                getOutputPath( ) + "populationSnapshots_mo_mga_EVEEJ.bin", numberOfIslands * 100, prob.get_nx( ), prob.get_nf( ) );
+    AsynchronousOutputQueue< PopulationSnapshot > snapshotOutput(
+                [ & ]( PopulationSnapshot& snapshot ){ snapshotWriter.writeSnapshot( snapshot ); } );
+    evolveArchipelago( archi, 512, 1, [ & ]( const pagmo::archipelago& currentArchipelago, const unsigned int i )
     {
-
-        isl.evolve( );
-        while( isl.status( ) != pagmo::evolve_status::idle &&
-               isl.status( ) != pagmo::evolve_status::idle_error )
-        {
-            isl.wait( );
-        }
-
-        isl.wait_check( ); // Raises errors
-
         // Write current iteration results to file
-        printPopulationToFile( isl.get_population( ).get_x( ), "mo_mga_EVEEJ_" + std::to_string( i ), false );
-        printPopulationToFile( isl.get_population( ).get_f( ), "mo_mga_EVEEJ_" + std::to_string( i ), true );
-        std::cout<<i<<std::endl;
-    }
+        snapshotOutput.addOutput( PopulationSnapshot(
+                                   i - 1, getArchipelagoDecisionVectors( currentArchipelago ), getArchipelagoFitnessVectors( currentArchipelago ) ) );
+        std::cout<<i - 1<<std::endl;
+    } );
+    snapshotOutput.waitForCompletion( );
+
+    std::cout<<"Fraction of Lambert arcs retrieved from cache: "
+            <<prob.extract< EveejMultipleGravityAssist >( )->getLambertCacheHitRate( )<<std::endl;
 
     return 0;
 
@@ -21,7 +21,11 @@
 #include "pagmo/algorithms/ihs.hpp"
 #include "Problems/earthMarsTransfer.h"
 #include "Problems/applicationOutput.h"
+#include "Problems/archipelagoDriver.h"
+#include "Problems/asynchronousOutput.h"
+#include "Problems/populationSnapshot.h"
 #include "Problems/getAlgorithm.h"
+#include "Problems/multiObjectiveMetrics.h"
 #include "Problems/saveOptimizationResults.h"
 
 using namespace tudat_pagmo_applications;
@@ -47,31 +51,38 @@ int main( )
     // Solve problem using 3 different optimizers
     for( unsigned int j = 0; j < 3; j++ )
     {
-        // Retrieve MO algorithm
+        // Retrieve MO algorithm, evaluating populations through the batch fitness of the problem where supported (nsga2)
         algorithm algo{getMultiObjectiveAlgorithm( j )};
-
-        // Create an island with 1024 individuals
-        island isl{algo, prob, 1024};
-
-        // Evolve for 25 generations
-        for( int i = 0 ; i < 100; i++ )
+        setBatchFitnessEvaluator( algo, prob );
+
+        // Create an archipelago of 8 islands with 128 individuals each (1024 individuals in total)
+        const unsigned int numberOfIslands = 8;
+        pagmo::archipelago archi = createArchipelago( algo, prob, numberOfIslands, 128 );
+
+        // Evolve for 100 generations, writing results to (binary) file after each generation
+        PopulationSnapshotWriter snapshotWriter(
+                    getOutputPath( ) + "populationSnapshots_mo_EarthMars_" + std::to_string( j ) + ".bin",
+                    numberOfIslands * 128, prob.get_nx( ), prob.get_nf( ) );
+        AsynchronousOutputQueue< PopulationSnapshot > snapshotOutput(
+                    [ & ]( PopulationSnapshot& snapshot ){ snapshotWriter.writeSnapshot( snapshot ); } );
+
+        // Log hypervolume (w.r.t. delta V of 20 km/s and maximum time of flight) and number of non-dominated individuals
+        MultiObjectiveMetricsLogger metricsLogger(
+                    getOutputPath( ) + "metrics_mo_EarthMars_" + std::to_string( j ) + ".dat", { 20.0E3, 1000.0 } );
+        evolveArchipelago( archi, 100, 1, [ & ]( const pagmo::archipelago& currentArchipelago, const unsigned int i )
         {
-            isl.evolve( );
-            while( isl.status( ) != pagmo::evolve_status::idle &&
-                   isl.status( ) != pagmo::evolve_status::idle_error )
-            {
-                isl.wait( );
-            }
-            isl.wait_check( ); // Raises errors
+            std::vector< pagmo::vector_double > decisionVectors = getArchipelagoDecisionVectors( currentArchipelago );
+            std::vector< pagmo::vector_double > fitnessVectors = getArchipelagoFitnessVectors( currentArchipelago );
 
-            // Write current iteration results to file
-            printPopulationToFile( isl.get_population( ).get_x( ), "mo_EarthMars_" + std::to_string( i ) + "_" + std::to_string( j ), false );
-            printPopulationToFile( isl.get_population( ).get_f( ), "mo_EarthMars_" + std::to_string( i ) + "_" + std::to_string( j ), true );
-
-            std::cout<<i<<" "<<j<<std::endl;
+            // Update convergence metrics
+            metricsLogger.addGeneration( i - 1, decisionVectors, fitnessVectors );
 
+            // Write current iteration results to file
+            snapshotOutput.addOutput( PopulationSnapshot( i - 1, std::move( decisionVectors ), std::move( fitnessVectors ) ) );
 
-        }
+            std::cout<<i - 1<<" "<<j<<std::endl;
+        } );
+        snapshotOutput.waitForCompletion( );
     }
 
     return 0;
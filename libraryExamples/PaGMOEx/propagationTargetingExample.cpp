@@ -23,9 +23,17 @@ approach distance from the target?*/
 #include <pagmo/io.hpp>
 #include <pagmo/archipelago.hpp>
 
+#include <limits>
+#include <map>
+
 #include "Problems/propagationTargeting.h"
+#include "Problems/multiFidelityOptimization.h"
 #include "Problems/applicationOutput.h"
+#include "Problems/archipelagoDriver.h"
+#include "Problems/asynchronousOutput.h"
+#include "Problems/populationSnapshot.h"
 #include "Problems/saveOptimizationResults.h"
+#include "Problems/surrogateAssistedProblem.h"
 
 #include "Tudat/External/SpiceInterface/spiceInterface.h"
 #include "Tudat/InputOutput/basicInputOutput.h"
@@ -59,112 +67,115 @@ int main( )
     std::shared_ptr< propagators::DependentVariableSaveSettings > dependentVariablesToSave =
             std::make_shared< propagators::DependentVariableSaveSettings >( dependentVariablesList );
 
-
+    // Create object to compute the problem fitness; without perturbations, the closest approach is computed analytically
+    // (so that no propagation is performed, and the pruning threshold is not used)
     PropagationTargetingProblem targetingProblem( altitudeOfPerigee, altitudeOfApogee, altitudeOfTarget,
-                                                  longitudeOfTarget, dependentVariablesToSave, false );
+                                                  longitudeOfTarget, dependentVariablesToSave, false, true );
 
     problem prob{ targetingProblem };
 
-    // Perform Grid Search and write results to file
+    // Perform Grid Search and write results to file.
     if( performGridSearch )
     {
         createGridSearch( prob, {{0.0, 0.0}, {360.0, 180.0}}, { 100, 50 }, "propagationTargetingGridSearch_" );
     }
-    // Instantiate a pagmo algorithm
-    algorithm algo{de1220( )};
 
-    // Create an island with 128 individuals
-    pagmo::population::size_type populationSize = 128;
-    island isl{algo, prob, populationSize};
+    // Create object to compute the problem fitness; with perturbations
+    PropagationTargetingProblem perturbedTargetingProblem( altitudeOfPerigee, altitudeOfApogee, altitudeOfTarget,
+                                                           longitudeOfTarget, dependentVariablesToSave, true );
+    problem prob_pert{ perturbedTargetingProblem };
 
-    // Evolve for 25 generations
-    for( int i = 0; i < 25; i++ )
+    // Perform Grid Search for perturbed priblem and write results to file
+    if( performGridSearch )
     {
-        isl.evolve( );
-        while( isl.status( ) != pagmo::evolve_status::idle &&
-               isl.status( ) != pagmo::evolve_status::idle_error )
-        {
-            isl.wait( );
-        }
-        isl.wait_check( ); // Raises errors
-
-        // Write current iteration results to file
-        printPopulationToFile( isl.get_population( ).get_x( ), "targetingPropagation_" + std::to_string( i ) + "_" + std::to_string( i ) , false );
-        printPopulationToFile( isl.get_population( ).get_f( ), "targetingPropagation_" + std::to_string( i ) + "_" + std::to_string( i ) , true );
-
-        std::cout<<i<<std::endl;
+        createGridSearch( prob_pert, {{0.0, 0.0}, {360.0, 180.0}}, { 100, 50 }, "propagationTargetingGridSearch_pert" );
     }
 
-    // Retrieve final Cartesian states for population in last generation, and save final states to a file.
-    std::vector<std::vector< double > > decisionVariables = isl.get_population( ).get_x( );
-    std::map< int, Eigen::VectorXd > finalStates;
-    for( unsigned int i = 0; i < decisionVariables.size( ); i++ )
-    {
-        targetingProblem.fitness( decisionVariables.at( i ) );
-        finalStates[ i ] = targetingProblem.getPreviousFinalState( );
-    }
-    tudat::input_output::writeDataMapToTextFile(
-                finalStates, "targetingFinalStates.dat", tudat_pagmo_applications::getOutputPath( ) );
+    // Instantiate a pagmo algorithm
+    algorithm algo{de1220( )};
 
-    // Retrieve final values of dependent variables for population in last generation, and save final dependent variables values to a file.
-    std::map< int, Eigen::VectorXd > dependentVariablesFinalValues;
-    for( unsigned int i = 0; i < decisionVariables.size( ); i++ )
+    // Optimize with unperturbed dynamics until converged (at most 25 generations), then with unperturbed dynamics corrected
+    // for the difference w.r.t. the perturbed dynamics, and finally with perturbed dynamics (at most 4 generations), where
+    // candidates are pre-screened with a surrogate model so that only the most promising ones are propagated.
+    // Stages are considered converged if the miss distance has improved by less than 1 m for 5 generations.
+    // Perturbed propagations that are terminated early by the pruning threshold only provide an upper bound on the miss
+    // distance, and are not used to train the surrogate.
+    std::shared_ptr< SurrogatePreScreeningSettings > preScreeningSettings =
+            std::make_shared< SurrogatePreScreeningSettings >( );
+    preScreeningSettings->isTrueEvaluationInexactFunction_ = &PropagationTargetingProblem::wasLastEvaluationPruned;
+    MultiFidelitySettings multiFidelitySettings( 25, 25, 4, 5, 1.0E-6, 1.0, 16, preScreeningSettings );
+
+    // Create an archipelago of 8 islands with 16 individuals each (128 individuals in total)
+    const unsigned int numberOfIslands = 8;
+    pagmo::population::size_type populationSizePerIsland = 16;
+
+    // Write population of each stage to (binary) file after each generation (and initial population for perturbed case)
+    std::map< MultiFidelityStage, std::string > snapshotFileSuffixes =
+    { { low_fidelity_stage, "" }, { corrected_low_fidelity_stage, "_corrected" }, { high_fidelity_stage, "_pert" } };
+    std::map< MultiFidelityStage, std::shared_ptr< PopulationSnapshotWriter > > snapshotWriters;
+    for( auto suffixIterator : snapshotFileSuffixes )
     {
-        targetingProblem.fitness( decisionVariables.at( i ) );
-        dependentVariablesFinalValues[ i ] = targetingProblem.getPreviousDependentVariablesFinalValues();
+        snapshotWriters[ suffixIterator.first ] = std::make_shared< PopulationSnapshotWriter >(
+                    getOutputPath( ) + "populationSnapshots_targetingPropagation" + suffixIterator.second + ".bin",
+                    numberOfIslands * populationSizePerIsland, prob.get_nx( ), prob.get_nf( ) );
     }
-    tudat::input_output::writeDataMapToTextFile(
-                dependentVariablesFinalValues, "targetingDependentVariablesFinalVariables.dat", tudat_pagmo_applications::getOutputPath( ) );
-
-
-    // Create object to compute the problem fitness; with perturbations
-    problem prob_pert{PropagationTargetingProblem( altitudeOfPerigee, altitudeOfApogee, altitudeOfTarget,
-                                                   longitudeOfTarget, dependentVariablesToSave, true ) };
-
-
-    // Instantiate a pagmo algorithm for the new problem.
-    algorithm algo_pert{de1220( )};
-
-    // Create an empty population for perturbed problem
-    population population_pert = population( prob_pert, 0 );
-
-    // Retrieve population of unperturbed problem, and instantiate population of perturbed problem
-    std::vector<vector_double> original_population = isl.get_population( ).get_x( );
-    for( unsigned int k = 0; k < populationSize; k++ )
+    AsynchronousOutputQueue< std::pair< MultiFidelityStage, PopulationSnapshot > > snapshotOutput(
+                [ & ]( std::pair< MultiFidelityStage, PopulationSnapshot >& snapshot )
     {
-        population_pert.push_back( original_population.at( k ) );
-    }
-
-    // Create island for perturbed problem
-    island isl_pert{algo_pert, population_pert};
+        snapshotWriters.at( snapshot.first )->writeSnapshot( snapshot.second );
+    } );
 
-    // Perform Grid Search for perturbed priblem and write results to file
-    if( performGridSearch )
+    MultiFidelityResults multiFidelityResults = performMultiFidelityOptimization(
+                algo, prob, prob_pert, numberOfIslands, populationSizePerIsland, multiFidelitySettings,
+                [ & ]( const pagmo::archipelago& currentArchipelago, const unsigned int i, const MultiFidelityStage stage )
     {
-        createGridSearch( isl_pert.get_population( ).get_problem( ), {{0.0, 0.0}, {360.0, 180.0}}, { 100, 50 }, "propagationTargetingGridSearch_pert" );
-    }
-
-    // Write original (unevolved) population to file
-    printPopulationToFile( isl_pert.get_population( ).get_x( ), "targetingPropagation_pert_orig" , false );
-    printPopulationToFile( isl_pert.get_population( ).get_f( ), "targetingPropagation_pert_orig" , true );
-
+        if( stage == low_fidelity_stage && i == 0 )
+        {
+            return;
+        }
 
-    // Evolve for 4 generations
-    for( int i = 0; i < 4; i++ )
-    {
-        isl_pert.evolve( );
-        while( isl_pert.status( ) != pagmo::evolve_status::idle &&
-               isl_pert.status( ) != pagmo::evolve_status::idle_error )
+        if( stage == high_fidelity_stage )
         {
-            isl_pert.wait( );
+            // Terminate perturbed propagations in next generation once they can no longer improve on the champion
+            perturbedTargetingProblem.setPruningThreshold( getArchipelagoChampion( currentArchipelago ).second.at( 0 ) );
         }
-        isl_pert.wait_check( ); // Raises errors
 
         // Write current iteration results to file
-        printPopulationToFile( isl_pert.get_population( ).get_x( ), "targetingPropagation_pert_" + std::to_string( i ) + "_" + std::to_string( i ) , false );
-        printPopulationToFile( isl_pert.get_population( ).get_f( ), "targetingPropagation_pert_" + std::to_string( i ) + "_" + std::to_string( i ) , true );
-
-        std::cout<<i<<std::endl;
+        snapshotOutput.addOutput( std::make_pair( stage, PopulationSnapshot(
+                                                      ( stage == low_fidelity_stage ) ? i - 1 : i,
+                                                      getArchipelagoDecisionVectors( currentArchipelago ),
+                                                      getArchipelagoFitnessVectors( currentArchipelago ) ) ) );
+
+        std::cout<<"Stage "<<stage<<": "<<i<<std::endl;
+    },
+    [ & ]( const MultiFidelityStage )
+    {
+        // Perturbed fitness must be exact when sampling the correction, and when re-evaluating the high-fidelity
+        // population (pruning threshold is set from its champion once it is evaluated)
+        perturbedTargetingProblem.setPruningThreshold( std::numeric_limits< double >::infinity( ) );
+    } );
+    snapshotOutput.waitForCompletion( );
+
+    std::cout<<"Perturbed propagations for correction: "
+             <<multiFidelityResults.numberOfHighFidelityEvaluations_.at( correction_sampling_stage )
+             <<"; in perturbed stage: "<<multiFidelityResults.numberOfHighFidelityEvaluations_.at( high_fidelity_stage )
+             <<std::endl;
+
+    // Retrieve final Cartesian states and final values of dependent variables for population in last generation of
+    // unperturbed case, and save them to files.
+    std::vector<std::vector< double > > decisionVariables =
+            getArchipelagoDecisionVectors( multiFidelityResults.lowFidelityArchipelago_ );
+    std::map< int, Eigen::VectorXd > finalStates;
+    std::map< int, Eigen::VectorXd > dependentVariablesFinalValues;
+    PropagationTargetingResults targetingResults;
+    for( unsigned int i = 0; i < decisionVariables.size( ); i++ )
+    {
+        targetingProblem.fitness( decisionVariables.at( i ), targetingResults );
+        finalStates[ i ] = targetingResults.finalState_;
+        dependentVariablesFinalValues[ i ] = targetingResults.dependentVariablesFinalValues_;
     }
+    tudat::input_output::writeDataMapToTextFile(
+                finalStates, "targetingFinalStates.dat", tudat_pagmo_applications::getOutputPath( ) );
+    tudat::input_output::writeDataMapToTextFile(
+                dependentVariablesFinalValues, "targetingDependentVariablesFinalVariables.dat", tudat_pagmo_applications::getOutputPath( ) );
 }
-
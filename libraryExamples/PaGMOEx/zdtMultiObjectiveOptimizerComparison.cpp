@@ -23,6 +23,9 @@
 #include "pagmo/island.hpp"
 #include "pagmo/problem.hpp"
 #include "Problems/himmelblau.h"
+#include "Problems/getAlgorithm.h"
+#include "Problems/applicationOutput.h"
+#include "Problems/multiObjectiveMetrics.h"
 
 template< typename OutputStream, typename ScalarType,
           int NumberOfRows, int NumberOfColumns, int Options, int MaximumRows, int MaximumCols >
@@ -79,31 +82,6 @@ void writeMatrixToFile( Eigen::Matrix< ScalarType, NumberOfRows, NumberOfColumns
     outputFile_.close( );
 }
 
-pagmo::algorithm getAlgorithm( const int index )
-{
-    switch( index )
-    {
-    case 0:
-    {
-        pagmo::algorithm algo{ pagmo::nsga2( ) };
-        return algo;
-        break;
-    }
-    case 1:
-    {
-        pagmo::algorithm algo{ pagmo::moead( ) };
-        return algo;
-        break;
-    }
-    case 2:
-    {
-        pagmo::algorithm algo{ pagmo::ihs( ) };
-        return algo;
-        break;
-    }
-    }
-}
-
 void printPopulationToFile( const int problemIndex, const int iterationIndex,
                             const std::vector< pagmo::vector_double >& population,
                             const bool isFitness )
@@ -135,26 +113,29 @@ int main( )
     {
         pagmo::problem prob{ pagmo::zdt( 3, 2 ) };//my_problem( 0, 5, 0, 5) };
 
-        pagmo::algorithm algo = getAlgorithm( i );
+        pagmo::algorithm algo = getMultiObjectiveAlgorithm( i );
 
         pagmo::island isl = pagmo::island{ algo, prob, 64 };
 
+        // Log hypervolume, IGD w.r.t. analytical front and number of non-dominated individuals for each generation
+        tudat_pagmo_applications::MultiObjectiveMetricsLogger metricsLogger(
+                    tudat_pagmo_applications::getOutputPath( ) + "metrics_mo_" + std::to_string( i ) + ".dat", { 1.1, 1.1 },
+                    tudat_pagmo_applications::getZdtParetoFront( 3 ) );
+
         for( int j = 1; j <= 64; j++ )
         {
 
             isl.evolve( );
-
-            //isl.get_population( ).get_f()
-
-            printPopulationToFile( i, j, isl.get_population( ).get_x( ), false );
-            printPopulationToFile( i, j, isl.get_population( ).get_f( ), true );
-
-            //std::cout << "Best x: " << isl.get_population().champion_x()[0] << std::endl;
-            //std::cout << "Best y: " << isl.get_population().champion_x()[1] << std::endl;
             while( isl.status()!=pagmo::evolve_status::idle )
                 isl.wait();
 
+            metricsLogger.addGeneration( j, isl.get_population( ).get_x( ), isl.get_population( ).get_f( ) );
         }
+
+        // Save only final population
+        printPopulationToFile( i, 64, isl.get_population( ).get_x( ), false );
+        printPopulationToFile( i, 64, isl.get_population( ).get_f( ), true );
+
         std::cout<<i<<" done"<<std::endl;
     }
     return 0;
@@ -11,6 +11,7 @@
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include <SatellitePropagatorExamples/applicationOutput.h>
+#include <SatellitePropagatorExamples/concatenatedStateHistory.h>
 
 //! Execute propagation of orbits of Asterix and Obelix around the Earth.
 int main( )
@@ -158,17 +159,10 @@ int main( )
     // Create simulation object and propagate dynamics.
     SingleArcDynamicsSimulator< > dynamicsSimulator(
                 bodyMap, integratorSettings, propagatorSettings, true, false, false );
-    std::map< double, Eigen::VectorXd > integrationResult = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
 
-    // Retrieve numerically integrated states of vehicles.
-    std::map< double, Eigen::VectorXd > asterixPropagationHistory;
-    std::map< double, Eigen::VectorXd > obelixPropagationHistory;
-    for( std::map< double, Eigen::VectorXd >::const_iterator stateIterator = integrationResult.begin( );
-         stateIterator != integrationResult.end( ); stateIterator++ )
-    {
-        asterixPropagationHistory[ stateIterator->first ] = stateIterator->second.segment( 0, 6 );
-        obelixPropagationHistory[ stateIterator->first ] = stateIterator->second.segment( 6, 6 );
-    }
+    // Retrieve numerically integrated states of vehicles (Asterix is body 0, Obelix is body 1).
+    tudat_applications::ConcatenatedStateHistory propagationHistory =
+            tudat_applications::getConcatenatedStateHistory( dynamicsSimulator );
 
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -178,22 +172,22 @@ int main( )
     std::string outputSubFolder = "TwoSatelliteExample/";
 
     // Write Asterix propagation history to file.
-    writeDataMapToTextFile( asterixPropagationHistory,
-                            "asterixPropagationHistory.dat",
-                            tudat_applications::getOutputPath( ) + outputSubFolder,
-                            "",
-                            std::numeric_limits< double >::digits10,
-                            std::numeric_limits< double >::digits10,
-                            "," );
+    propagationHistory.writeBodyStateHistoryToTextFile( 0,
+                                                        "asterixPropagationHistory.dat",
+                                                        tudat_applications::getOutputPath( ) + outputSubFolder,
+                                                        "",
+                                                        std::numeric_limits< double >::digits10,
+                                                        std::numeric_limits< double >::digits10,
+                                                        "," );
 
     // Write obelix propagation history to file.
-    writeDataMapToTextFile( obelixPropagationHistory,
-                            "obelixPropagationHistory.dat",
-                            tudat_applications::getOutputPath( ) + outputSubFolder,
-                            "",
-                            std::numeric_limits< double >::digits10,
-                            std::numeric_limits< double >::digits10,
-                            "," );
+    propagationHistory.writeBodyStateHistoryToTextFile( 1,
+                                                        "obelixPropagationHistory.dat",
+                                                        tudat_applications::getOutputPath( ) + outputSubFolder,
+                                                        "",
+                                                        std::numeric_limits< double >::digits10,
+                                                        std::numeric_limits< double >::digits10,
+                                                        "," );
 
     // Final statement.
     // The exit code EXIT_SUCCESS indicates that the program was successfully executed.
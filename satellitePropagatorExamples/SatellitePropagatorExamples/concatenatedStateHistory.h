@@ -0,0 +1,393 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_CONCATENATED_STATE_HISTORY_H
+#define TUDAT_CONCATENATED_STATE_HISTORY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <Eigen/Core>
+
+namespace tudat_applications
+{
+
+//! Function to write a single entry (epoch and state) of a state history to a stream, as a single line.
+/*!
+ *  Function to write a single entry (epoch and state) of a state history to a stream, as a single line, in the same format
+ *  as tudat::input_output::writeDataMapToTextFile.
+ *  \param outputStream Stream to which the entry is written
+ *  \param epoch Epoch of entry
+ *  \param state State of entry (row or column vector)
+ *  \param precisionOfEpochs Number of significant digits of the epoch
+ *  \param precisionOfStates Number of significant digits of the state entries
+ *  \param delimiter Delimiter between entries on the line
+ */
+template< typename StateType >
+void writeStateEntryToStream( std::ostream& outputStream, const double epoch, const Eigen::DenseBase< StateType >& state,
+                              const int precisionOfEpochs, const int precisionOfStates, const std::string& delimiter )
+{
+    outputStream << std::setprecision( precisionOfEpochs ) << std::left << std::setw( precisionOfEpochs + 1 ) << epoch;
+    for( int i = 0; i < state.size( ); i++ )
+    {
+        outputStream << delimiter << std::setprecision( precisionOfStates ) << std::left
+                     << std::setw( precisionOfStates + 1 ) << state( i );
+    }
+    outputStream << '\n';
+}
+
+//! Propagation history of the concatenated state of a set of bodies, stored contiguously.
+/*!
+ *  Propagation history of the concatenated state of a set of bodies (e.g. the result of a propagation of the translational
+ *  state of multiple bodies, with the state of body i in entries 6i to 6i+5). The epochs are stored in a single array, and
+ *  the states in a single dense (row-major) matrix, with one row per epoch. The history of a single body is retrieved as a
+ *  strided view into this matrix, so that splitting the history per body (and writing it to file) requires no copies, and
+ *  no memory is allocated per epoch (as is the case for a std::map). Equivalently, the states form a column-major matrix
+ *  with one state per column (see getStateBlock).
+ *
+ *  The history can be used in place of a std::map< double, Eigen::VectorXd > in code that iterates over it: the iterators
+ *  provide the epoch and state of an entry as first and second, and find/lower_bound/upper_bound use a binary search on
+ *  the (contiguous) epochs.
+ */
+class ConcatenatedStateHistory
+{
+public:
+
+    //! Type for dense matrix with one state per row
+    typedef Eigen::Matrix< double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor > StateHistoryMatrix;
+
+    //! Type for (read-only) view of the complete state history
+    typedef Eigen::Map< const StateHistoryMatrix > StateHistoryView;
+
+    //! Type for (read-only) view of the state history of a single body, with one state per row
+    typedef Eigen::Map< const StateHistoryMatrix, Eigen::Unaligned, Eigen::OuterStride< > > BodyStateHistoryView;
+
+    //! Type for (read-only) view of the complete state history, with one state per column
+    typedef Eigen::Map< const Eigen::MatrixXd > StateBlockView;
+
+    //! Entry of the history, with the same member names as an entry of a std::map< double, Eigen::VectorXd >
+    struct StateHistoryEntry
+    {
+        StateHistoryEntry( const double epoch, const double* state, const int stateSize ):
+            first( epoch ), second( state, stateSize ){ }
+
+        //! Epoch of entry
+        double first;
+
+        //! View of the (concatenated) state at epoch
+        Eigen::Map< const Eigen::VectorXd > second;
+    };
+
+    //! Random-access iterator over the entries of the history (dereferences to a StateHistoryEntry, by value)
+    class const_iterator
+    {
+    public:
+
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef StateHistoryEntry value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef StateHistoryEntry reference;
+
+        //! Helper type through which operator-> provides access to the entry
+        struct pointer
+        {
+            const StateHistoryEntry* operator->( ) const { return &entry_; }
+            StateHistoryEntry entry_;
+        };
+
+        const_iterator( ): history_( nullptr ), index_( 0 ){ }
+
+        const_iterator( const ConcatenatedStateHistory* history, const difference_type index ):
+            history_( history ), index_( index ){ }
+
+        reference operator*( ) const
+        {
+            return StateHistoryEntry( history_->epochs_[ index_ ],
+                                      history_->states_.data( ) + index_ * history_->stateSize_, history_->stateSize_ );
+        }
+
+        pointer operator->( ) const { return pointer{ **this }; }
+
+        reference operator[]( const difference_type offset ) const { return *( *this + offset ); }
+
+        const_iterator& operator++( ){ ++index_; return *this; }
+        const_iterator operator++( int ){ const_iterator previous = *this; ++index_; return previous; }
+        const_iterator& operator--( ){ --index_; return *this; }
+        const_iterator operator--( int ){ const_iterator previous = *this; --index_; return previous; }
+
+        const_iterator& operator+=( const difference_type offset ){ index_ += offset; return *this; }
+        const_iterator& operator-=( const difference_type offset ){ index_ -= offset; return *this; }
+        const_iterator operator+( const difference_type offset ) const { return const_iterator( history_, index_ + offset ); }
+        const_iterator operator-( const difference_type offset ) const { return const_iterator( history_, index_ - offset ); }
+        difference_type operator-( const const_iterator& other ) const { return index_ - other.index_; }
+
+        bool operator==( const const_iterator& other ) const { return index_ == other.index_; }
+        bool operator!=( const const_iterator& other ) const { return index_ != other.index_; }
+        bool operator<( const const_iterator& other ) const { return index_ < other.index_; }
+        bool operator>( const const_iterator& other ) const { return index_ > other.index_; }
+        bool operator<=( const const_iterator& other ) const { return index_ <= other.index_; }
+        bool operator>=( const const_iterator& other ) const { return index_ >= other.index_; }
+
+        //! Function to retrieve the index of the entry in the history
+        difference_type getIndex( ) const { return index_; }
+
+    private:
+
+        const ConcatenatedStateHistory* history_;
+
+        difference_type index_;
+    };
+
+    typedef const_iterator iterator;
+
+    //! Constructor for empty history, to which states are added by addState.
+    /*!
+     *  Constructor for empty history, to which states are added by addState.
+     *  \param stateSize Size of concatenated state
+     *  \param bodyStateSize Size of state of a single body
+     *  \param expectedNumberOfEpochs Number of epochs for which memory is reserved
+     */
+    ConcatenatedStateHistory( const int stateSize, const int bodyStateSize = 6, const int expectedNumberOfEpochs = 0 ):
+        stateSize_( stateSize ), bodyStateSize_( bodyStateSize )
+    {
+        checkStateSizes( );
+        epochs_.reserve( expectedNumberOfEpochs );
+        states_.reserve( static_cast< std::size_t >( expectedNumberOfEpochs ) * stateSize_ );
+    }
+
+    //! Constructor from propagation history in map (e.g. from SingleArcDynamicsSimulator), which is copied.
+    /*!
+     *  Constructor from propagation history in map (e.g. from SingleArcDynamicsSimulator::
+     *  getEquationsOfMotionNumericalSolution), which is copied.
+     *  \param stateHistory Propagation history of concatenated state
+     *  \param bodyStateSize Size of state of a single body
+     */
+    ConcatenatedStateHistory( const std::map< double, Eigen::VectorXd >& stateHistory, const int bodyStateSize = 6 ):
+        stateSize_( stateHistory.empty( ) ? bodyStateSize : stateHistory.begin( )->second.rows( ) ),
+        bodyStateSize_( bodyStateSize )
+    {
+        checkStateSizes( );
+        epochs_.reserve( stateHistory.size( ) );
+        states_.reserve( stateHistory.size( ) * stateSize_ );
+        for( auto stateIterator = stateHistory.begin( ); stateIterator != stateHistory.end( ); stateIterator++ )
+        {
+            addState( stateIterator->first, stateIterator->second );
+        }
+    }
+
+    //! Function to add the state at the next epoch (which must be later than all epochs currently in the history)
+    void addState( const double epoch, const Eigen::VectorXd& state )
+    {
+        if( state.rows( ) != stateSize_ )
+        {
+            throw std::runtime_error( "Error when adding state to concatenated state history, state has incorrect size." );
+        }
+        appendEpoch( epoch ) = state;
+    }
+
+    //! Function to add the next epoch, returning a (writable) view of the state at that epoch, to be set by the user.
+    Eigen::Map< Eigen::VectorXd > appendEpoch( const double epoch )
+    {
+        if( !epochs_.empty( ) && !( epoch > epochs_.back( ) ) )
+        {
+            throw std::runtime_error( "Error when adding state to concatenated state history, epochs must be increasing." );
+        }
+        epochs_.push_back( epoch );
+        states_.resize( states_.size( ) + stateSize_ );
+        return Eigen::Map< Eigen::VectorXd >( states_.data( ) + states_.size( ) - stateSize_, stateSize_ );
+    }
+
+    //! Function to retrieve the number of epochs in the history
+    int getNumberOfEpochs( ) const
+    {
+        return static_cast< int >( epochs_.size( ) );
+    }
+
+    //! Function to retrieve the number of bodies of which the state is concatenated
+    int getNumberOfBodies( ) const
+    {
+        return stateSize_ / bodyStateSize_;
+    }
+
+    //! Function to retrieve the epochs in the history
+    const std::vector< double >& getEpochs( ) const
+    {
+        return epochs_;
+    }
+
+    //! Function to retrieve a view of the concatenated states (one row per epoch)
+    StateHistoryView getStates( ) const
+    {
+        return StateHistoryView( states_.data( ), getNumberOfEpochs( ), stateSize_ );
+    }
+
+    //! Function to retrieve a view of the concatenated states (one column per epoch)
+    StateBlockView getStateBlock( ) const
+    {
+        return StateBlockView( states_.data( ), stateSize_, getNumberOfEpochs( ) );
+    }
+
+    //! Function to retrieve iterator to first entry
+    const_iterator begin( ) const
+    {
+        return const_iterator( this, 0 );
+    }
+
+    //! Function to retrieve iterator past last entry
+    const_iterator end( ) const
+    {
+        return const_iterator( this, getNumberOfEpochs( ) );
+    }
+
+    //! Function to retrieve the number of entries (epochs) in the history
+    std::size_t size( ) const
+    {
+        return epochs_.size( );
+    }
+
+    //! Function to check whether the history is empty
+    bool empty( ) const
+    {
+        return epochs_.empty( );
+    }
+
+    //! Function to retrieve iterator to the first entry with epoch not before the given epoch (binary search)
+    const_iterator lower_bound( const double epoch ) const
+    {
+        return const_iterator( this, std::lower_bound( epochs_.begin( ), epochs_.end( ), epoch ) - epochs_.begin( ) );
+    }
+
+    //! Function to retrieve iterator to the first entry with epoch after the given epoch (binary search)
+    const_iterator upper_bound( const double epoch ) const
+    {
+        return const_iterator( this, std::upper_bound( epochs_.begin( ), epochs_.end( ), epoch ) - epochs_.begin( ) );
+    }
+
+    //! Function to retrieve iterator to the entry at exactly the given epoch, or end( ) if there is none (binary search)
+    const_iterator find( const double epoch ) const
+    {
+        const_iterator entryIterator = lower_bound( epoch );
+        return ( entryIterator != end( ) && entryIterator->first == epoch ) ? entryIterator : end( );
+    }
+
+    //! Function to retrieve the state at exactly the given epoch, throwing an exception if there is no such entry
+    Eigen::Map< const Eigen::VectorXd > getStateAtEpoch( const double epoch ) const
+    {
+        const_iterator entryIterator = find( epoch );
+        if( entryIterator == end( ) )
+        {
+            throw std::runtime_error( "Error when retrieving state from concatenated state history, epoch not found." );
+        }
+        return entryIterator->second;
+    }
+
+    //! Function to retrieve a view of the state history of a single body (one row per epoch), without copying.
+    BodyStateHistoryView getBodyStateHistory( const int bodyIndex ) const
+    {
+        if( bodyIndex < 0 || bodyIndex >= getNumberOfBodies( ) )
+        {
+            throw std::runtime_error( "Error when retrieving body state history, body index out of range." );
+        }
+        return BodyStateHistoryView( states_.data( ) + bodyIndex * bodyStateSize_, getNumberOfEpochs( ), bodyStateSize_,
+                                     Eigen::OuterStride< >( stateSize_ ) );
+    }
+
+    //! Function to write the state history of a single body to a text file.
+    /*!
+     *  Function to write the state history of a single body to a text file, in the same format as
+     *  tudat::input_output::writeDataMapToTextFile (epoch, followed by the state entries, on each line), directly from the
+     *  contiguous history.
+     *  \param bodyIndex Index of body in concatenated state
+     *  \param outputFilename Name of output file
+     *  \param outputDirectory Directory of output file (created if it does not exist)
+     *  \param fileHeader Header written at the start of the file
+     *  \param precisionOfEpochs Number of significant digits of the epochs
+     *  \param precisionOfStates Number of significant digits of the state entries
+     *  \param delimiter Delimiter between entries on a line
+     */
+    void writeBodyStateHistoryToTextFile( const int bodyIndex,
+                                          const std::string& outputFilename,
+                                          const std::string& outputDirectory,
+                                          const std::string& fileHeader = "",
+                                          const int precisionOfEpochs = 10,
+                                          const int precisionOfStates = 10,
+                                          const std::string& delimiter = "\t" ) const
+    {
+        BodyStateHistoryView bodyStateHistory = getBodyStateHistory( bodyIndex );
+
+        // Check if output directory exists; create it if it doesn't.
+        if( !boost::filesystem::exists( outputDirectory ) )
+        {
+            boost::filesystem::create_directories( outputDirectory );
+        }
+
+        std::ofstream outputFile( ( outputDirectory + "/" + outputFilename ).c_str( ) );
+        outputFile << fileHeader;
+        for( int i = 0; i < bodyStateHistory.rows( ); i++ )
+        {
+            writeStateEntryToStream( outputFile, epochs_[ i ], bodyStateHistory.row( i ),
+                                     precisionOfEpochs, precisionOfStates, delimiter );
+        }
+        outputFile.close( );
+    }
+
+private:
+
+    //! Function to check whether the concatenated state consists of an integer number of body states
+    void checkStateSizes( ) const
+    {
+        if( bodyStateSize_ <= 0 || stateSize_ % bodyStateSize_ != 0 )
+        {
+            throw std::runtime_error( "Error in concatenated state history, state size is not a multiple of body state size." );
+        }
+    }
+
+    //! Size of concatenated state
+    int stateSize_;
+
+    //! Size of state of a single body
+    int bodyStateSize_;
+
+    //! Epochs in history (in increasing order)
+    std::vector< double > epochs_;
+
+    //! Concatenated states in history, stored row-major (all entries at a single epoch are contiguous)
+    std::vector< double > states_;
+};
+
+//! Function to retrieve the propagation history of a dynamics simulator as a concatenated state history.
+/*!
+ *  Function to retrieve the propagation history of a dynamics simulator (e.g. SingleArcDynamicsSimulator), of which the
+ *  numerical solution is copied into a concatenated state history, for contiguous access to and iteration over the states.
+ *  The numerical solution is copied directly from the simulator, without an intermediate map; it is kept by the simulator
+ *  until the simulator is destroyed.
+ *  \param dynamicsSimulator Dynamics simulator that has propagated the equations of motion
+ *  \param bodyStateSize Size of state of a single body
+ *  \return Propagation history of the concatenated state of the propagated bodies
+ */
+template< typename DynamicsSimulatorType >
+ConcatenatedStateHistory getConcatenatedStateHistory( DynamicsSimulatorType& dynamicsSimulator, const int bodyStateSize = 6 )
+{
+    return ConcatenatedStateHistory( dynamicsSimulator.getEquationsOfMotionNumericalSolution( ), bodyStateSize );
+}
+
+} // namespace tudat_applications
+
+#endif // TUDAT_CONCATENATED_STATE_HISTORY_H
@@ -0,0 +1,250 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_CONSTELLATION_PROPAGATOR_H
+#define TUDAT_CONSTELLATION_PROPAGATOR_H
+
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+#include <Eigen/Core>
+
+namespace tudat_applications
+{
+
+//! Function to convert (geodesy-)normalized cosine coefficients to unnormalized zonal coefficients J_n = -C_n0.
+/*!
+ *  Function to convert (geodesy-)normalized cosine coefficients to unnormalized zonal coefficients J_n = -C_n0, as used by
+ *  ConstellationPropagator.
+ *  \param normalizedCosineCoefficients Normalized cosine coefficients (row = degree, column = order)
+ *  \param maximumDegree Maximum degree of zonal coefficients
+ *  \return Zonal coefficients, indexed by degree (entries of degree 0 and 1 are zero)
+ */
+inline Eigen::VectorXd convertCosineCoefficientsToZonalCoefficients(
+        const Eigen::MatrixXd& normalizedCosineCoefficients, const int maximumDegree )
+{
+    if( normalizedCosineCoefficients.rows( ) <= maximumDegree )
+    {
+        throw std::runtime_error( "Error when retrieving zonal coefficients, maximum degree exceeds gravity field degree." );
+    }
+
+    Eigen::VectorXd zonalCoefficients = Eigen::VectorXd::Zero( maximumDegree + 1 );
+    for( int degree = 2; degree <= maximumDegree; degree++ )
+    {
+        // Normalization factor of zonal terms is sqrt( 2n + 1 )
+        zonalCoefficients( degree ) = -std::sqrt( 2.0 * degree + 1.0 ) * normalizedCosineCoefficients( degree, 0 );
+    }
+    return zonalCoefficients;
+}
+
+//! Propagator for a constellation of non-interacting satellites about a common central body, with a zonal gravity field.
+/*!
+ *  Propagator for a constellation of non-interacting satellites about a common central body, of which the gravity field
+ *  consists of the zonal spherical harmonic terms (order 0) only, with its symmetry axis along the z-axis of the
+ *  (inertial) propagation frame. This is the dynamics of a spherical harmonic acceleration of degree n and order 0 about a
+ *  central body rotating about the z-axis.
+ *
+ *  The states of all satellites are stored as a structure of arrays: each Cartesian component is a contiguous array over
+ *  the satellites (a column of a column-major ConstellationStateArray). The acceleration is evaluated by a single kernel
+ *  that operates on entire arrays (recursion for the Legendre polynomials and their derivatives, vectorized by Eigen
+ *  across the satellites), instead of separate acceleration model objects per satellite. The equations of motion are
+ *  integrated with a fixed-step fourth-order Runge-Kutta method. All buffers are allocated once per constellation size.
+ */
+class ConstellationPropagator
+{
+public:
+
+    //! Type for states of all satellites: one row per satellite, columns are position and velocity components
+    typedef Eigen::Array< double, Eigen::Dynamic, 6 > ConstellationStateArray;
+
+    //! Function type that is called with the epoch and states after each step (and for the initial states)
+    typedef std::function< void( const double, const ConstellationStateArray& ) > ConstellationOutputFunction;
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param gravitationalParameter Gravitational parameter of central body
+     *  \param referenceRadius Reference radius of gravity field
+     *  \param zonalCoefficients Unnormalized zonal coefficients J_n, indexed by degree (entries of degree 0 and 1 are
+     *  ignored), see convertCosineCoefficientsToZonalCoefficients
+     */
+    ConstellationPropagator( const double gravitationalParameter,
+                             const double referenceRadius,
+                             const Eigen::VectorXd& zonalCoefficients ):
+        gravitationalParameter_( gravitationalParameter ), referenceRadius_( referenceRadius ),
+        zonalCoefficients_( zonalCoefficients ){ }
+
+    //! Function to compute the time derivative of the states of all satellites
+    /*!
+     *  Function to compute the time derivative of the states of all satellites
+     *  \param states Current states of all satellites
+     *  \param stateDerivatives Time derivatives of states (returned by reference, must have same size as states)
+     */
+    void computeStateDerivatives( const ConstellationStateArray& states, ConstellationStateArray& stateDerivatives )
+    {
+        resizeBuffers( states.rows( ) );
+
+        // Inverse distance and sine of latitude (w.r.t. symmetry axis) of all satellites
+        inverseRadius_ = ( states.col( 0 ).square( ) + states.col( 1 ).square( ) + states.col( 2 ).square( ) ).rsqrt( );
+        sineOfLatitude_ = states.col( 2 ) * inverseRadius_;
+
+        // Sum zonal terms, with Legendre polynomials P_n and derivatives P_n' from recursion (P_1 = u, P_1' = 1)
+        radialFactor_.setConstant( -1.0 );
+        axialFactor_.setZero( );
+        previousLegendrePolynomial_.setOnes( );
+        legendrePolynomial_ = sineOfLatitude_;
+        legendrePolynomialDerivative_.setOnes( );
+        radiusRatioPower_ = referenceRadius_ * inverseRadius_;
+        for( int degree = 2; degree < zonalCoefficients_.rows( ); degree++ )
+        {
+            // n P_n = ( 2n - 1 ) u P_(n-1) - ( n - 1 ) P_(n-2) and P_n' = n P_(n-1) + u P_(n-1)'
+            legendrePolynomialDerivative_ = degree * legendrePolynomial_ + sineOfLatitude_ * legendrePolynomialDerivative_;
+            nextLegendrePolynomial_ = ( ( 2.0 * degree - 1.0 ) * sineOfLatitude_ * legendrePolynomial_ -
+                                        ( degree - 1.0 ) * previousLegendrePolynomial_ ) / degree;
+            previousLegendrePolynomial_.swap( legendrePolynomial_ );
+            legendrePolynomial_.swap( nextLegendrePolynomial_ );
+
+            radiusRatioPower_ *= referenceRadius_ * inverseRadius_;
+            if( zonalCoefficients_( degree ) != 0.0 )
+            {
+                radialFactor_ += zonalCoefficients_( degree ) * radiusRatioPower_ *
+                        ( ( degree + 1.0 ) * legendrePolynomial_ + sineOfLatitude_ * legendrePolynomialDerivative_ );
+                axialFactor_ += zonalCoefficients_( degree ) * radiusRatioPower_ * legendrePolynomialDerivative_;
+            }
+        }
+
+        // a = mu / r^3 * radialFactor * r_vec - mu / r^2 * axialFactor * z_hat
+        radialFactor_ *= gravitationalParameter_ * inverseRadius_.cube( );
+        axialFactor_ *= gravitationalParameter_ * inverseRadius_.square( );
+
+        stateDerivatives.resize( states.rows( ), 6 );
+        stateDerivatives.leftCols< 3 >( ) = states.rightCols< 3 >( );
+        stateDerivatives.col( 3 ) = radialFactor_ * states.col( 0 );
+        stateDerivatives.col( 4 ) = radialFactor_ * states.col( 1 );
+        stateDerivatives.col( 5 ) = radialFactor_ * states.col( 2 ) - axialFactor_;
+    }
+
+    //! Function to propagate the states of all satellites with a fixed-step Runge-Kutta 4 integrator
+    /*!
+     *  Function to propagate the states of all satellites with a fixed-step Runge-Kutta 4 integrator. The final step is
+     *  shortened to end exactly at the end epoch.
+     *  \param initialStates Initial states of all satellites
+     *  \param startEpoch Epoch of initial states
+     *  \param endEpoch Epoch at which propagation is terminated
+     *  \param stepSize Integration step size
+     *  \param outputFunction Function called with the epoch and states after each step, and for the initial states
+     *  \return States of all satellites at end epoch
+     */
+    ConstellationStateArray propagate( const ConstellationStateArray& initialStates,
+                                       const double startEpoch,
+                                       const double endEpoch,
+                                       const double stepSize,
+                                       const ConstellationOutputFunction outputFunction = ConstellationOutputFunction( ) )
+    {
+        if( !( stepSize > 0.0 ) || endEpoch < startEpoch )
+        {
+            throw std::runtime_error( "Error when propagating constellation, invalid step size or propagation interval." );
+        }
+
+        ConstellationStateArray currentStates = initialStates;
+        double currentEpoch = startEpoch;
+        if( outputFunction )
+        {
+            outputFunction( currentEpoch, currentStates );
+        }
+
+        // Number of steps is computed beforehand, so that rounding errors in the epoch do not add a step
+        const long long numberOfSteps = static_cast< long long >( std::ceil( ( endEpoch - startEpoch ) / stepSize - 1.0E-9 ) );
+        for( long long i = 0; i < numberOfSteps; i++ )
+        {
+            const double currentStepSize = ( i == numberOfSteps - 1 ) ? ( endEpoch - currentEpoch ) : stepSize;
+
+            computeStateDerivatives( currentStates, firstStageDerivatives_ );
+            intermediateStates_ = currentStates + 0.5 * currentStepSize * firstStageDerivatives_;
+            computeStateDerivatives( intermediateStates_, secondStageDerivatives_ );
+            intermediateStates_ = currentStates + 0.5 * currentStepSize * secondStageDerivatives_;
+            computeStateDerivatives( intermediateStates_, thirdStageDerivatives_ );
+            intermediateStates_ = currentStates + currentStepSize * thirdStageDerivatives_;
+            computeStateDerivatives( intermediateStates_, fourthStageDerivatives_ );
+
+            currentStates += currentStepSize / 6.0 * (
+                        firstStageDerivatives_ + 2.0 * secondStageDerivatives_ +
+                        2.0 * thirdStageDerivatives_ + fourthStageDerivatives_ );
+            currentEpoch = ( i == numberOfSteps - 1 ) ? endEpoch : startEpoch + ( i + 1 ) * stepSize;
+
+            if( outputFunction )
+            {
+                outputFunction( currentEpoch, currentStates );
+            }
+        }
+
+        return currentStates;
+    }
+
+private:
+
+    //! Function to (re)allocate the buffers of the acceleration kernel (no allocation if size is unchanged)
+    void resizeBuffers( const Eigen::Index numberOfSatellites )
+    {
+        if( inverseRadius_.rows( ) != numberOfSatellites )
+        {
+            inverseRadius_.resize( numberOfSatellites );
+            sineOfLatitude_.resize( numberOfSatellites );
+            radiusRatioPower_.resize( numberOfSatellites );
+            previousLegendrePolynomial_.resize( numberOfSatellites );
+            legendrePolynomial_.resize( numberOfSatellites );
+            nextLegendrePolynomial_.resize( numberOfSatellites );
+            legendrePolynomialDerivative_.resize( numberOfSatellites );
+            radialFactor_.resize( numberOfSatellites );
+            axialFactor_.resize( numberOfSatellites );
+        }
+    }
+
+    double gravitationalParameter_;
+
+    double referenceRadius_;
+
+    Eigen::VectorXd zonalCoefficients_;
+
+    //! Buffers of acceleration kernel, one entry per satellite
+    Eigen::ArrayXd inverseRadius_;
+
+    Eigen::ArrayXd sineOfLatitude_;
+
+    Eigen::ArrayXd radiusRatioPower_;
+
+    Eigen::ArrayXd previousLegendrePolynomial_;
+
+    Eigen::ArrayXd legendrePolynomial_;
+
+    Eigen::ArrayXd nextLegendrePolynomial_;
+
+    Eigen::ArrayXd legendrePolynomialDerivative_;
+
+    Eigen::ArrayXd radialFactor_;
+
+    Eigen::ArrayXd axialFactor_;
+
+    //! Buffers of integrator
+    ConstellationStateArray intermediateStates_;
+
+    ConstellationStateArray firstStageDerivatives_;
+
+    ConstellationStateArray secondStageDerivatives_;
+
+    ConstellationStateArray thirdStageDerivatives_;
+
+    ConstellationStateArray fourthStageDerivatives_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_CONSTELLATION_PROPAGATOR_H
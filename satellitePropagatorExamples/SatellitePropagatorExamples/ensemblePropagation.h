@@ -0,0 +1,212 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_ENSEMBLE_PROPAGATION_H
+#define TUDAT_ENSEMBLE_PROPAGATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+#include <SatellitePropagatorExamples/concatenatedStateHistory.h>
+
+namespace tudat_applications
+{
+
+//! Function to check whether the propagated bodies are dynamically independent of one another.
+/*!
+ *  Function to check whether the propagated bodies are dynamically independent of one another, i.e. whether none of the
+ *  propagated bodies exerts an acceleration on, or is the central body of, any of the propagated bodies. In that case, the
+ *  dynamics of each body can be propagated separately.
+ *  \param accelerationSettings Settings for the accelerations acting on the propagated bodies
+ *  \param bodiesToPropagate Names of propagated bodies
+ *  \param centralBodies Names of central bodies (one per propagated body)
+ *  \return True if the propagated bodies are dynamically independent
+ */
+inline bool areBodiesDynamicallyIndependent(
+        const tudat::simulation_setup::SelectedAccelerationMap& accelerationSettings,
+        const std::vector< std::string >& bodiesToPropagate,
+        const std::vector< std::string >& centralBodies )
+{
+    auto isBodyPropagated = [ & ]( const std::string& bodyName )
+    {
+        return std::find( bodiesToPropagate.begin( ), bodiesToPropagate.end( ), bodyName ) != bodiesToPropagate.end( );
+    };
+
+    for( unsigned int i = 0; i < centralBodies.size( ); i++ )
+    {
+        if( isBodyPropagated( centralBodies.at( i ) ) )
+        {
+            return false;
+        }
+    }
+
+    for( const auto& accelerationIterator : accelerationSettings )
+    {
+        if( !isBodyPropagated( accelerationIterator.first ) )
+        {
+            continue;
+        }
+
+        for( const auto& exertingBodyIterator : accelerationIterator.second )
+        {
+            if( isBodyPropagated( exertingBodyIterator.first ) )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//! Function to propagate a set of dynamically independent bodies in parallel, each with its own integrator.
+/*!
+ *  Function to propagate the translational dynamics of a set of dynamically independent bodies (e.g. the satellites of a
+ *  constellation, without mutual interaction). Instead of a single coupled propagation, in which all bodies share a single
+ *  integrator (and step size sequence), each body is propagated separately, with its own integrator, distributed over a set
+ *  of threads. Variable step-size integrators therefore adapt the step size to each body separately.
+ *
+ *  Since the bodies in an environment are modified during a propagation, each thread uses its own environment, created by
+ *  the environmentCreationFunction. The environments are all created on the calling thread before the propagation starts,
+ *  as the creation of the environment may not be thread-safe (e.g. when retrieving data from Spice). The first exception
+ *  thrown during any propagation is rethrown on the calling thread, after all threads have been joined.
+ *  \param environmentCreationFunction Function creating the environment (including all propagated bodies)
+ *  \param accelerationSettings Settings for the accelerations acting on the propagated bodies
+ *  \param bodiesToPropagate Names of propagated bodies
+ *  \param centralBodies Names of central bodies (one per propagated body)
+ *  \param systemInitialState Initial states of the propagated bodies, concatenated in the order of bodiesToPropagate
+ *  \param simulationEndEpoch Epoch at which the propagation of each body is terminated
+ *  \param integratorSettingsFunction Function creating the integrator settings for the body with the given index
+ *  \param numberOfThreads Number of threads to use (0 for number of available hardware threads)
+ *  \param checkDynamicalIndependence Boolean denoting whether to check that the bodies are dynamically independent (see
+ *  areBodiesDynamicallyIndependent), and throw an exception if they are not.
+ *  \return Propagation history of each body (in the order of bodiesToPropagate)
+ */
+inline std::vector< ConcatenatedStateHistory > propagateIndependentBodiesInParallel(
+        const std::function< tudat::simulation_setup::NamedBodyMap( ) > environmentCreationFunction,
+        const tudat::simulation_setup::SelectedAccelerationMap& accelerationSettings,
+        const std::vector< std::string >& bodiesToPropagate,
+        const std::vector< std::string >& centralBodies,
+        const Eigen::VectorXd& systemInitialState,
+        const double simulationEndEpoch,
+        const std::function< std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > >(
+            const unsigned int ) > integratorSettingsFunction,
+        const unsigned int numberOfThreads = 0,
+        const bool checkDynamicalIndependence = true )
+{
+    using namespace tudat;
+    using namespace tudat::simulation_setup;
+    using namespace tudat::propagators;
+
+    const unsigned int numberOfBodies = bodiesToPropagate.size( );
+    if( centralBodies.size( ) != numberOfBodies || systemInitialState.rows( ) != 6 * static_cast< int >( numberOfBodies ) )
+    {
+        throw std::runtime_error( "Error in ensemble propagation, inconsistent number of bodies, central bodies and states." );
+    }
+
+    if( checkDynamicalIndependence &&
+            !areBodiesDynamicallyIndependent( accelerationSettings, bodiesToPropagate, centralBodies ) )
+    {
+        throw std::runtime_error( "Error in ensemble propagation, propagated bodies are not dynamically independent." );
+    }
+
+    // Create one environment per thread
+    unsigned int numberOfWorkers =
+            ( numberOfThreads > 0 ) ? numberOfThreads : std::max( std::thread::hardware_concurrency( ), 1u );
+    numberOfWorkers = std::max( std::min( numberOfWorkers, numberOfBodies ), 1u );
+
+    std::vector< NamedBodyMap > environments;
+    for( unsigned int i = 0; i < numberOfWorkers; i++ )
+    {
+        environments.push_back( environmentCreationFunction( ) );
+    }
+
+    // Propagate bodies, each thread retrieving the next body to propagate when it is done with the previous one
+    std::vector< ConcatenatedStateHistory > propagationHistories( numberOfBodies, ConcatenatedStateHistory( 6 ) );
+    std::atomic< unsigned int > nextBodyIndex( 0 );
+
+    std::mutex exceptionMutex;
+    std::exception_ptr firstException;
+    std::atomic< bool > hasPropagationFailed( false );
+
+    auto workerFunction = [ & ]( const unsigned int threadIndex )
+    {
+        try
+        {
+            unsigned int bodyIndex;
+            while( !hasPropagationFailed && ( bodyIndex = nextBodyIndex++ ) < numberOfBodies )
+            {
+                const std::string& currentBody = bodiesToPropagate.at( bodyIndex );
+
+                SelectedAccelerationMap currentAccelerationSettings;
+                if( accelerationSettings.count( currentBody ) > 0 )
+                {
+                    currentAccelerationSettings[ currentBody ] = accelerationSettings.at( currentBody );
+                }
+
+                const std::vector< std::string > currentBodiesToPropagate = { currentBody };
+                const std::vector< std::string > currentCentralBodies = { centralBodies.at( bodyIndex ) };
+                basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                            environments.at( threadIndex ), currentAccelerationSettings,
+                            currentBodiesToPropagate, currentCentralBodies );
+
+                std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
+                        std::make_shared< TranslationalStatePropagatorSettings< double > >(
+                            currentCentralBodies, accelerationModelMap, currentBodiesToPropagate,
+                            systemInitialState.segment( 6 * bodyIndex, 6 ), simulationEndEpoch );
+
+                SingleArcDynamicsSimulator< > dynamicsSimulator(
+                            environments.at( threadIndex ), integratorSettingsFunction( bodyIndex ), propagatorSettings );
+                propagationHistories[ bodyIndex ] = getConcatenatedStateHistory( dynamicsSimulator );
+            }
+        }
+        catch( ... )
+        {
+            std::lock_guard< std::mutex > lock( exceptionMutex );
+            if( !firstException )
+            {
+                firstException = std::current_exception( );
+            }
+            hasPropagationFailed = true;
+        }
+    };
+
+    std::vector< std::thread > workerThreads;
+    for( unsigned int i = 1; i < numberOfWorkers; i++ )
+    {
+        workerThreads.push_back( std::thread( workerFunction, i ) );
+    }
+    workerFunction( 0 );
+
+    for( unsigned int i = 0; i < workerThreads.size( ); i++ )
+    {
+        workerThreads.at( i ).join( );
+    }
+
+    if( firstException )
+    {
+        std::rethrow_exception( firstException );
+    }
+
+    return propagationHistories;
+}
+
+} // namespace tudat_applications
+
+#endif // TUDAT_ENSEMBLE_PROPAGATION_H
@@ -11,9 +11,12 @@
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include <SatellitePropagatorExamples/applicationOutput.h>
+#include <SatellitePropagatorExamples/concatenatedStateHistory.h>
+#include <SatellitePropagatorExamples/constellationPropagator.h>
+#include <SatellitePropagatorExamples/ensemblePropagation.h>
 
 //! Execute simulation of Galileo constellation around the Earth.
-int main( )
+int main( int argc, char* argv[ ] )
 {
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////            USING STATEMENTS              //////////////////////////////////////////////////////
@@ -42,6 +45,20 @@ int main( )
     // Set numerical integration fixed step size.
     const double fixedStepSize = 30.0;
 
+    // Set propagation method from (optional) command-line argument. By default, the coupled state of all satellites is
+    // propagated by the dynamics simulator with a single fixed step-size integrator. Alternatively, each satellite is
+    // propagated separately (in parallel, with its own variable step-size integrator) by the dynamics simulator
+    // ("ensemble"), or all satellites are propagated with the dedicated (structure-of-arrays) constellation propagator
+    // ("constellation").
+    const std::string propagationMethod = ( argc > 1 ) ? std::string( argv[ 1 ] ) : "coupled";
+    if( propagationMethod != "coupled" && propagationMethod != "ensemble" && propagationMethod != "constellation" )
+    {
+        throw std::runtime_error( "Error in Galileo constellation example, unknown propagation method " +
+                                  propagationMethod + ", use coupled, ensemble or constellation." );
+    }
+    const bool useConstellationPropagator = ( propagationMethod == "constellation" );
+    const bool useEnsemblePropagation = ( propagationMethod == "ensemble" );
+
     // Set number of satellites in constellation.
     const unsigned int numberOfSatellites = 30;
 
@@ -64,19 +81,25 @@ int main( )
     bodySettings[ "Earth" ]->atmosphereSettings = NULL;
     bodySettings[ "Earth" ]->shapeModelSettings = NULL;
 
-    // Create Earth object
-    simulation_setup::NamedBodyMap bodyMap = simulation_setup::createBodies( bodySettings );
-
-    // Set accelerations for each satellite.
+    // Define function to create environment (also used to create separate environments for parallel propagation)
     std::string currentSatelliteName;
-    for ( unsigned int i = 0; i < numberOfSatellites; i++ )
+    auto createEnvironment = [ & ]( )
     {
-        currentSatelliteName =  "Satellite" + boost::lexical_cast< std::string >( i );
-        bodyMap[ currentSatelliteName ] = std::make_shared< simulation_setup::Body >( );
-    }
+        // Create Earth object
+        simulation_setup::NamedBodyMap currentBodyMap = simulation_setup::createBodies( bodySettings );
 
-    // Finalize body creation.
-    setGlobalFrameBodyEphemerides( bodyMap, "SSB", "J2000" );
+        // Create satellite objects.
+        for ( unsigned int i = 0; i < numberOfSatellites; i++ )
+        {
+            currentBodyMap[ "Satellite" + boost::lexical_cast< std::string >( i ) ] =
+                    std::make_shared< simulation_setup::Body >( );
+        }
+
+        // Finalize body creation.
+        setGlobalFrameBodyEphemerides( currentBodyMap, "SSB", "J2000" );
+        return currentBodyMap;
+    };
+    simulation_setup::NamedBodyMap bodyMap = createEnvironment( );
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////    DEFINE CONSTELLATION INITIAL STATES      ///////////////////////////////////////////////////
@@ -160,61 +183,116 @@ int main( )
         systemInitialState.segment( i * 6, 6 ) = initialConditions.col( i );
     }
 
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////             CREATE ACCELERATIONS            ///////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-    // Define propagator settings variables.
-    SelectedAccelerationMap accelerationMap;
-    std::vector< std::string > bodiesToPropagate;
-    std::vector< std::string > centralBodies;
+    // Retrieve numerically integrated state for each satellite. The history contains the concatenated state of all
+    // satellites (single entry), or the state of a single satellite (one entry per satellite) if the satellites are
+    // propagated separately.
+    std::vector< tudat_applications::ConcatenatedStateHistory > allSatellitesPropagationHistory;
 
-    // Set accelerations for each satellite.
-    for ( unsigned int i = 0; i < numberOfSatellites; i++ )
+    if( useConstellationPropagator )
     {
-        currentSatelliteName = "Satellite" + boost::lexical_cast< std::string >( i );
-
-        std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > accelerationsOfCurrentSatellite;
-        accelerationsOfCurrentSatellite[ "Earth" ].push_back(
-                    std::make_shared< SphericalHarmonicAccelerationSettings >( 4, 0 ) );
-        accelerationMap[ currentSatelliteName ] = accelerationsOfCurrentSatellite;
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ///////////////////////         PROPAGATE CONSTELLATION (STRUCTURE-OF-ARRAYS)       ///////////////////////////////
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Retrieve zonal coefficients up to degree 4 (equivalent to spherical harmonic acceleration of degree 4, order 0)
+        std::shared_ptr< gravitation::SphericalHarmonicsGravityField > earthGravityField =
+                std::dynamic_pointer_cast< gravitation::SphericalHarmonicsGravityField >(
+                    bodyMap.at( "Earth" )->getGravityFieldModel( ) );
+        if( earthGravityField == nullptr )
+        {
+            throw std::runtime_error( "Error in Galileo constellation example, Earth gravity field is not spherical harmonic." );
+        }
 
-        bodiesToPropagate.push_back( currentSatelliteName );
-        centralBodies.push_back( "Earth" );
+        tudat_applications::ConstellationPropagator constellationPropagator(
+                    earthGravityField->getGravitationalParameter( ), earthGravityField->getReferenceRadius( ),
+                    tudat_applications::convertCosineCoefficientsToZonalCoefficients(
+                        earthGravityField->getCosineCoefficients( ), 4 ) );
+
+        // Propagate all satellites at once, and retrieve state of each satellite after each step.
+        tudat_applications::ConstellationPropagator::ConstellationStateArray constellationInitialStates =
+                initialConditions.transpose( ).array( );
+        allSatellitesPropagationHistory.push_back( tudat_applications::ConcatenatedStateHistory(
+                    6 * numberOfSatellites, 6,
+                    static_cast< int >( std::ceil( ( simulationEndEpoch - simulationStartEpoch ) / fixedStepSize ) ) + 1 ) );
+        constellationPropagator.propagate(
+                    constellationInitialStates, simulationStartEpoch, simulationEndEpoch, fixedStepSize,
+                    [ & ]( const double currentEpoch,
+                    const tudat_applications::ConstellationPropagator::ConstellationStateArray& currentStates )
+        {
+            Eigen::Map< Eigen::VectorXd > currentConcatenatedState =
+                    allSatellitesPropagationHistory.at( 0 ).appendEpoch( currentEpoch );
+            for( unsigned int i = 0; i < numberOfSatellites; i++ )
+            {
+                currentConcatenatedState.segment( i * 6, 6 ) = currentStates.row( i ).transpose( ).matrix( );
+            }
+        } );
     }
+    else
+    {
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ///////////////////////             CREATE ACCELERATIONS            ///////////////////////////////////////////////
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+        // Define propagator settings variables.
+        SelectedAccelerationMap accelerationMap;
+        std::vector< std::string > bodiesToPropagate;
+        std::vector< std::string > centralBodies;
 
-    // Create acceleration models and propagation settings.
-    basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
-                bodyMap, accelerationMap, bodiesToPropagate, centralBodies );
-
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////             CREATE PROPAGATION SETTINGS            ////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-    std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
-            std::make_shared< TranslationalStatePropagatorSettings< double > >(
-                centralBodies, accelerationModelMap, bodiesToPropagate, systemInitialState, simulationEndEpoch );
-    std::shared_ptr< IntegratorSettings< > > integratorSettings =
-            std::make_shared< IntegratorSettings< > >( rungeKutta4, simulationStartEpoch, fixedStepSize );
+        // Set accelerations for each satellite.
+        for ( unsigned int i = 0; i < numberOfSatellites; i++ )
+        {
+            currentSatelliteName = "Satellite" + boost::lexical_cast< std::string >( i );
 
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////             PROPAGATE ORBIT            ////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > accelerationsOfCurrentSatellite;
+            accelerationsOfCurrentSatellite[ "Earth" ].push_back(
+                        std::make_shared< SphericalHarmonicAccelerationSettings >( 4, 0 ) );
+            accelerationMap[ currentSatelliteName ] = accelerationsOfCurrentSatellite;
 
-    // Create simulation object and propagate dynamics.
-    SingleArcDynamicsSimulator< > dynamicsSimulator( bodyMap, integratorSettings, propagatorSettings );
-    std::map< double, Eigen::VectorXd > integrationResult = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+            bodiesToPropagate.push_back( currentSatelliteName );
+            centralBodies.push_back( "Earth" );
+        }
 
-    // Retrieve numerically integrated state for each satellite.
-    std::vector< std::map< double, Eigen::VectorXd > > allSatellitesPropagationHistory;
-    allSatellitesPropagationHistory.resize( numberOfSatellites );
-    for( std::map< double, Eigen::VectorXd >::const_iterator stateIterator = integrationResult.begin( );
-         stateIterator != integrationResult.end( ); stateIterator++ )
-    {
-        for( unsigned int i = 0; i < allSatellitesPropagationHistory.size( ); i++ )
+        if( useEnsemblePropagation )
+        {
+            ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            ///////////////////////         PROPAGATE SATELLITES SEPARATELY IN PARALLEL       /////////////////////////////
+            ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+            // Propagate each satellite with its own variable step-size integrator, so that the step size is not limited by
+            // the satellite with the most demanding dynamics.
+            allSatellitesPropagationHistory = tudat_applications::propagateIndependentBodiesInParallel(
+                        createEnvironment, accelerationMap, bodiesToPropagate, centralBodies,
+                        systemInitialState, simulationEndEpoch, [ & ]( const unsigned int )
+            {
+                return std::make_shared< RungeKuttaVariableStepSizeSettingsScalarTolerances< > >(
+                            simulationStartEpoch, fixedStepSize, RungeKuttaCoefficients::rungeKuttaFehlberg78,
+                            1.0, 3600.0, 1.0E-10, 1.0E-10 );
+            } );
+        }
+        else
         {
-            allSatellitesPropagationHistory[ i ][ stateIterator->first ] = stateIterator->second.segment( i * 6, 6 );
+            // Create acceleration models and propagation settings.
+            basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                        bodyMap, accelerationMap, bodiesToPropagate, centralBodies );
+
+            ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            ///////////////////////             CREATE PROPAGATION SETTINGS            ////////////////////////////////////
+            ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+            std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
+                    std::make_shared< TranslationalStatePropagatorSettings< double > >(
+                        centralBodies, accelerationModelMap, bodiesToPropagate, systemInitialState, simulationEndEpoch );
+            std::shared_ptr< IntegratorSettings< > > integratorSettings =
+                    std::make_shared< IntegratorSettings< > >( rungeKutta4, simulationStartEpoch, fixedStepSize );
+
+            ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            ///////////////////////             PROPAGATE ORBIT            ////////////////////////////////////////////////
+            ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+            // Create simulation object and propagate dynamics.
+            SingleArcDynamicsSimulator< > dynamicsSimulator( bodyMap, integratorSettings, propagatorSettings );
+            allSatellitesPropagationHistory.push_back(
+                        tudat_applications::getConcatenatedStateHistory( dynamicsSimulator ) );
         }
     }
 
@@ -232,13 +310,15 @@ int main( )
         outputFilename << "galileoSatellite" << i + 1 << ".dat";
 
         // Write propagation history to file.
-        writeDataMapToTextFile( allSatellitesPropagationHistory.at( i ),
-                                outputFilename.str( ),
-                                tudat_applications::getOutputPath( ) + outputSubFolder,
-                                "",
-                                std::numeric_limits< double >::digits10,
-                                std::numeric_limits< double >::digits10,
-                                "," );
+        const bool isHistoryConcatenated = ( allSatellitesPropagationHistory.size( ) == 1 );
+        allSatellitesPropagationHistory.at( isHistoryConcatenated ? 0 : i ).writeBodyStateHistoryToTextFile(
+                    isHistoryConcatenated ? i : 0,
+                    outputFilename.str( ),
+                    tudat_applications::getOutputPath( ) + outputSubFolder,
+                    "",
+                    std::numeric_limits< double >::digits10,
+                    std::numeric_limits< double >::digits10,
+                    "," );
     }
 
     // Final statement.
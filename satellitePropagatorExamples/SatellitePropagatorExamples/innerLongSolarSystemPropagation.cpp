@@ -11,6 +11,7 @@
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include "SatellitePropagatorExamples/applicationOutput.h"
+#include "SatellitePropagatorExamples/streamingPropagation.h"
 
 //! Simulate the dynamics of the main bodies in the inner solar system
 int main( )
@@ -124,40 +125,22 @@ int main( )
                     bodiesToPropagate, centralBodies, bodyMap, initialEphemerisTime );
 
 
-        std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
-                std::make_shared< TranslationalStatePropagatorSettings< double > >
-                ( centralBodies, accelerationModelMap, bodiesToPropagate, systemInitialState, finalEphemerisTime,
-                  cowell, std::shared_ptr< DependentVariableSaveSettings >( ) );
-
-        // Define numerical integrator settings.
-        std::shared_ptr< IntegratorSettings< > > integratorSettings =
-                std::make_shared< BulirschStoerIntegratorSettings< double > >(
-                    initialEphemerisTime, 3600.0, bulirsch_stoer_sequence, 6,
-                    std::numeric_limits< double >::epsilon( ), std::numeric_limits< double >::infinity( ),
-                    1.0E-10, 1.0E-8, 10 );
-
-        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        ///////////////////////             PROPAGATE ORBITS            ///////////////////////////////////////////////////
-        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-        // Create simulation object and propagate dynamics.
-        SingleArcDynamicsSimulator< > dynamicsSimulator(
-                    bodyMap, integratorSettings, propagatorSettings, true, false, false );
-
-        std::map< double, Eigen::VectorXd > integrationResult = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-
-        // Retrieve numerically integrated state for each body.
-        std::vector< std::map< double, Eigen::VectorXd > > allBodiesPropagationHistory;
-        allBodiesPropagationHistory.resize( numberOfNumericalBodies );
-        for( std::map< double, Eigen::VectorXd >::const_iterator stateIterator = integrationResult.begin( );
-             stateIterator != integrationResult.end( ); stateIterator++ )
+        // Define function to create propagator settings for a single segment of the arc (see propagation below).
+        auto createPropagatorSettings = [ & ]( const Eigen::VectorXd& segmentInitialState, const double segmentEndEpoch )
         {
-            for( unsigned int i = 0; i < numberOfNumericalBodies; i++ )
-            {
-                allBodiesPropagationHistory[ i ][ stateIterator->first ] = stateIterator->second.segment( i * 6, 6 );
-            }
-        }
+            return std::make_shared< TranslationalStatePropagatorSettings< double > >
+                    ( centralBodies, accelerationModelMap, bodiesToPropagate, segmentInitialState, segmentEndEpoch,
+                      cowell, std::shared_ptr< DependentVariableSaveSettings >( ) );
+        };
 
+        // Define function to create numerical integrator settings for a single segment of the arc.
+        auto createIntegratorSettings = [ & ]( const double segmentStartEpoch )
+        {
+            return std::make_shared< BulirschStoerIntegratorSettings< double > >(
+                        segmentStartEpoch, 3600.0, bulirsch_stoer_sequence, 6,
+                        std::numeric_limits< double >::epsilon( ), std::numeric_limits< double >::infinity( ),
+                        1.0E-10, 1.0E-8, 10 );
+        };
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////        PROVIDE OUTPUT TO FILES           ////////////////////////////////////////////////
@@ -165,18 +148,28 @@ int main( )
 
         std::string outputSubFolder = "InnerSolarSystemPropagationExample/";
 
+        // Write propagation history of each body to file while propagating, so that it is never kept in memory.
+        std::vector< std::string > outputFilenames;
         for( unsigned int i = 0; i < numberOfNumericalBodies; i++ )
         {
-            // Write propagation history to file.
-            input_output::writeDataMapToTextFile(
-                        allBodiesPropagationHistory[ i ],
-                        "innerLongSolarSystemPropagationHistory" + bodyNames.at( i ) + ".dat",
-                        tudat_applications::getOutputPath( ) + outputSubFolder,
-                        "",
-                        std::numeric_limits< double >::digits10,
-                        std::numeric_limits< double >::digits10,
-                        "," );
+            outputFilenames.push_back( "innerLongSolarSystemPropagationHistory" + bodyNames.at( i ) + ".dat" );
         }
+        std::vector< std::shared_ptr< tudat_applications::PropagationOutputSink > > stateOutputSinks;
+        stateOutputSinks.push_back( std::make_shared< tudat_applications::TextFileOutputSink >(
+                                        outputFilenames,
+                                        tudat_applications::getOutputPath( ) + outputSubFolder,
+                                        std::numeric_limits< double >::digits10,
+                                        std::numeric_limits< double >::digits10,
+                                        "," ) );
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ///////////////////////             PROPAGATE ORBITS            ///////////////////////////////////////////////////
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Propagate dynamics in segments of 10 years, streaming the output of each segment to file.
+        tudat_applications::propagateWithStreamingOutput(
+                    bodyMap, createIntegratorSettings, createPropagatorSettings, systemInitialState,
+                    initialEphemerisTime, finalEphemerisTime, 10.0 * physical_constants::JULIAN_YEAR, stateOutputSinks );
     }
 
     tend = time(0);
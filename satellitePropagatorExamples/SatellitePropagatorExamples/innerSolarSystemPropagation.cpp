@@ -11,6 +11,7 @@
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include "SatellitePropagatorExamples/applicationOutput.h"
+#include "SatellitePropagatorExamples/concatenatedStateHistory.h"
 
 //! Simulate the dynamics of the main bodies in the inner solar system
 int main( )
@@ -151,19 +152,9 @@ int main( )
         // Create simulation object and propagate dynamics.
         SingleArcDynamicsSimulator< > dynamicsSimulator( bodyMap, integratorSettings, propagatorSettings );
 
-        std::map< double, Eigen::VectorXd > integrationResult = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-
         // Retrieve numerically integrated state for each body.
-        std::vector< std::map< double, Eigen::VectorXd > > allBodiesPropagationHistory;
-        allBodiesPropagationHistory.resize( numberOfNumericalBodies );
-        for( std::map< double, Eigen::VectorXd >::const_iterator stateIterator = integrationResult.begin( );
-             stateIterator != integrationResult.end( ); stateIterator++ )
-        {
-            for( unsigned int i = 0; i < numberOfNumericalBodies; i++ )
-            {
-                allBodiesPropagationHistory[ i ][ stateIterator->first ] = stateIterator->second.segment( i * 6, 6 );
-            }
-        }
+        tudat_applications::ConcatenatedStateHistory allBodiesPropagationHistory =
+                tudat_applications::getConcatenatedStateHistory( dynamicsSimulator );
 
         /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////        PROVIDE OUTPUT TO FILES           ////////////////////////////////////////////////
@@ -174,8 +165,8 @@ int main( )
         for( unsigned int i = 0; i < numberOfNumericalBodies; i++ )
         {
             // Write propagation history to file.
-            input_output::writeDataMapToTextFile(
-                        allBodiesPropagationHistory[ i ],
+            allBodiesPropagationHistory.writeBodyStateHistoryToTextFile(
+                        i,
                         "innerSolarSystemPropagationHistory" + bodyNames.at( i ) +
                         boost::lexical_cast< std::string >( centralBodySettings ) + ".dat",
                         tudat_applications::getOutputPath( ) + outputSubFolder,
@@ -11,6 +11,7 @@
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include "SatellitePropagatorExamples/applicationOutput.h"
+#include "SatellitePropagatorExamples/streamingPropagation.h"
 
 //! Execute propagation of orbit of TeslaRoadster around the Earth.
 int main( )
@@ -184,52 +185,56 @@ int main( )
     std::shared_ptr< DependentVariableSaveSettings > dependentVariablesToSave =
             std::make_shared< DependentVariableSaveSettings >( dependentVariablesList );
 
-    std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
-            std::make_shared< TranslationalStatePropagatorSettings< double > >
-            ( centralBodies, accelerationModelMap, bodiesToPropagate, teslaRoadsterInitialState, simulationEndEpoch, cowell,
-              dependentVariablesToSave );
-
-    std::shared_ptr< IntegratorSettings< > > integratorSettings
-            = std::make_shared< tudat::numerical_integrators::BulirschStoerIntegratorSettings< > >(
-                simulationStartEpoch, 3600.0,
-                numerical_integrators::bulirsch_stoer_sequence, 4,
-                std::numeric_limits< double >::epsilon( ), std::numeric_limits< double >::infinity( ),
-                1.0E-15, 1.0E-12 );
+    // Define function to create propagator settings for a single segment of the arc (see propagation below).
+    auto createPropagatorSettings = [ & ]( const Eigen::VectorXd& segmentInitialState, const double segmentEndEpoch )
+    {
+        return std::make_shared< TranslationalStatePropagatorSettings< double > >
+                ( centralBodies, accelerationModelMap, bodiesToPropagate, segmentInitialState, segmentEndEpoch, cowell,
+                  dependentVariablesToSave );
+    };
+
+    // Define function to create numerical integrator settings for a single segment of the arc.
+    auto createIntegratorSettings = [ & ]( const double segmentStartEpoch )
+    {
+        return std::make_shared< tudat::numerical_integrators::BulirschStoerIntegratorSettings< > >(
+                    segmentStartEpoch, 3600.0,
+                    numerical_integrators::bulirsch_stoer_sequence, 4,
+                    std::numeric_limits< double >::epsilon( ), std::numeric_limits< double >::infinity( ),
+                    1.0E-15, 1.0E-12 );
+    };
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////             PROPAGATE ORBIT            ////////////////////////////////////////////////////////
+    ///////////////////////        PROVIDE OUTPUT TO FILES           //////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    std::string outputSubFolder = "SpacexTeslaExample/";
 
-    // Create simulation object and propagate dynamics.
-    SingleArcDynamicsSimulator< > dynamicsSimulator(
-                bodyMap, integratorSettings, propagatorSettings, true, false, false );
-    std::map< double, Eigen::VectorXd > integrationResult = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-    std::map< double, Eigen::VectorXd > dependentVariableResult = dynamicsSimulator.getDependentVariableHistory( );
-
+    // Write propagation and dependent variable history to file while propagating, so that they are never kept in memory.
+    std::vector< std::shared_ptr< tudat_applications::PropagationOutputSink > > stateOutputSinks;
+    stateOutputSinks.push_back( std::make_shared< tudat_applications::TextFileOutputSink >(
+                                    std::vector< std::string >( { "spacexTeslaPropagationHistory.dat" } ),
+                                    tudat_applications::getOutputPath( ) + outputSubFolder,
+                                    std::numeric_limits< double >::digits10,
+                                    std::numeric_limits< double >::digits10,
+                                    "," ) );
+
+    std::vector< std::shared_ptr< tudat_applications::PropagationOutputSink > > dependentVariableOutputSinks;
+    dependentVariableOutputSinks.push_back( std::make_shared< tudat_applications::TextFileOutputSink >(
+                                                std::vector< std::string >( { "spacexTeslaDependentVariableHistory.dat" } ),
+                                                tudat_applications::getOutputPath( ) + outputSubFolder,
+                                                std::numeric_limits< double >::digits10,
+                                                std::numeric_limits< double >::digits10,
+                                                "," ) );
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////        PROVIDE OUTPUT TO CONSOLE AND FILES           //////////////////////////////////////////
+    ///////////////////////             PROPAGATE ORBIT            ////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    std::string outputSubFolder = "SpacexTeslaExample/";
-
-    // Write perturbed satellite propagation history to file.
-    input_output::writeDataMapToTextFile( integrationResult,
-                                          "spacexTeslaPropagationHistory.dat",
-                                          tudat_applications::getOutputPath( ) + outputSubFolder,
-                                          "",
-                                          std::numeric_limits< double >::digits10,
-                                          std::numeric_limits< double >::digits10,
-                                          "," );
-
-    input_output::writeDataMapToTextFile( dependentVariableResult,
-                                          "spacexTeslaDependentVariableHistory.dat",
-                                          tudat_applications::getOutputPath( ) + outputSubFolder,
-                                          "",
-                                          std::numeric_limits< double >::digits10,
-                                          std::numeric_limits< double >::digits10,
-                                          "," );
+    // Propagate dynamics in segments of 10 years, streaming the output of each segment to file.
+    tudat_applications::propagateWithStreamingOutput(
+                bodyMap, createIntegratorSettings, createPropagatorSettings, teslaRoadsterInitialState,
+                simulationStartEpoch, simulationEndEpoch, 10.0 * physical_constants::JULIAN_YEAR,
+                stateOutputSinks, dependentVariableOutputSinks );
 
 
     // Final statement.
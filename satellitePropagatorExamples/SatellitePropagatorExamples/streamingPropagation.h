@@ -0,0 +1,287 @@
+/*    Copyright (c) 2010-2019, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_STREAMING_PROPAGATION_H
+#define TUDAT_STREAMING_PROPAGATION_H
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+#include <SatellitePropagatorExamples/concatenatedStateHistory.h>
+
+namespace tudat_applications
+{
+
+//! Base class for objects that receive the output of a propagation, one epoch at a time.
+class PropagationOutputSink
+{
+public:
+
+    //! Destructor
+    virtual ~PropagationOutputSink( ){ }
+
+    //! Function called for each output epoch (in increasing order), with the state (or dependent variables) at that epoch
+    virtual void processOutput( const double epoch, const Eigen::VectorXd& output ) = 0;
+
+    //! Function called when the propagation is finished
+    virtual void finalizeOutput( ){ }
+};
+
+//! Output sink that writes each output epoch to one or more text files as soon as it is received.
+/*!
+ *  Output sink that writes each output epoch to one or more text files as soon as it is received, in the same format as
+ *  tudat::input_output::writeDataMapToTextFile. The output vector is split into equal blocks, one per file (e.g. one file
+ *  per body for a concatenated translational state).
+ */
+class TextFileOutputSink: public PropagationOutputSink
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor, opens the output files.
+     *  \param outputFilenames Names of output files, one per block of the output vector
+     *  \param outputDirectory Directory of output files (created if it does not exist)
+     *  \param precisionOfEpochs Number of significant digits of the epochs
+     *  \param precisionOfOutput Number of significant digits of the output entries
+     *  \param delimiter Delimiter between entries on a line
+     */
+    TextFileOutputSink( const std::vector< std::string >& outputFilenames,
+                        const std::string& outputDirectory,
+                        const int precisionOfEpochs = 10,
+                        const int precisionOfOutput = 10,
+                        const std::string& delimiter = "\t" ):
+        precisionOfEpochs_( precisionOfEpochs ), precisionOfOutput_( precisionOfOutput ), delimiter_( delimiter )
+    {
+        // Check if output directory exists; create it if it doesn't.
+        if( !boost::filesystem::exists( outputDirectory ) )
+        {
+            boost::filesystem::create_directories( outputDirectory );
+        }
+
+        for( unsigned int i = 0; i < outputFilenames.size( ); i++ )
+        {
+            outputFiles_.push_back( std::make_shared< std::ofstream >(
+                                        ( outputDirectory + "/" + outputFilenames.at( i ) ).c_str( ) ) );
+            if( !outputFiles_.back( )->is_open( ) )
+            {
+                throw std::runtime_error( "Error in text file output sink, could not open file " + outputFilenames.at( i ) );
+            }
+        }
+    }
+
+    //! Function to write the output at a single epoch to the output files
+    void processOutput( const double epoch, const Eigen::VectorXd& output )
+    {
+        const int blockSize = output.rows( ) / static_cast< int >( outputFiles_.size( ) );
+        if( blockSize * static_cast< int >( outputFiles_.size( ) ) != output.rows( ) )
+        {
+            throw std::runtime_error( "Error in text file output sink, output size is not a multiple of number of files." );
+        }
+
+        for( unsigned int i = 0; i < outputFiles_.size( ); i++ )
+        {
+            writeStateEntryToStream( *outputFiles_.at( i ), epoch, output.segment( i * blockSize, blockSize ),
+                                     precisionOfEpochs_, precisionOfOutput_, delimiter_ );
+        }
+    }
+
+    //! Function to close the output files
+    void finalizeOutput( )
+    {
+        for( unsigned int i = 0; i < outputFiles_.size( ); i++ )
+        {
+            outputFiles_.at( i )->close( );
+        }
+    }
+
+private:
+
+    std::vector< std::shared_ptr< std::ofstream > > outputFiles_;
+
+    int precisionOfEpochs_;
+
+    int precisionOfOutput_;
+
+    std::string delimiter_;
+};
+
+//! Output sink that passes each output epoch to a user-defined function (e.g. to reduce the output to a statistic).
+class FunctionOutputSink: public PropagationOutputSink
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param outputFunction Function called for each output epoch, with the epoch and output
+     *  \param finalizationFunction Function called when the propagation is finished (optional)
+     */
+    FunctionOutputSink( const std::function< void( const double, const Eigen::VectorXd& ) > outputFunction,
+                        const std::function< void( ) > finalizationFunction = std::function< void( ) >( ) ):
+        outputFunction_( outputFunction ), finalizationFunction_( finalizationFunction ){ }
+
+    //! Function to pass the output at a single epoch to the output function
+    void processOutput( const double epoch, const Eigen::VectorXd& output )
+    {
+        outputFunction_( epoch, output );
+    }
+
+    //! Function to call the finalization function (if any)
+    void finalizeOutput( )
+    {
+        if( finalizationFunction_ )
+        {
+            finalizationFunction_( );
+        }
+    }
+
+private:
+
+    std::function< void( const double, const Eigen::VectorXd& ) > outputFunction_;
+
+    std::function< void( ) > finalizationFunction_;
+};
+
+//! Function to propagate a single arc in segments, streaming the output to a set of sinks instead of keeping it in memory.
+/*!
+ *  Function to propagate a single arc in segments of (approximately) fixed duration, streaming the output to a set of
+ *  sinks. Each segment is propagated with a new SingleArcDynamicsSimulator, starting from the final state of the previous
+ *  segment, after which its output is passed to the sinks and discarded. The memory use is therefore set by the segment
+ *  duration, not by the total arc length. Note that the integrator is restarted (with its initial step size) at the start
+ *  of each segment.
+ *
+ *  The propagator and integrator settings are created per segment by the user-defined functions. The propagation of each
+ *  segment is terminated by the propagator settings at the segment end epoch (the final segment ends at the end epoch);
+ *  the next segment starts at the last epoch of the previous one. The initial state and every outputFrequency-th
+ *  integration step are passed to the sinks.
+ *  \param bodyMap List of bodies in the simulation
+ *  \param integratorSettingsFunction Function creating integrator settings, starting at the given epoch
+ *  \param propagatorSettingsFunction Function creating propagator settings, with the given initial state and termination
+ *  epoch
+ *  \param initialState Initial state of the propagation
+ *  \param startEpoch Epoch of the initial state
+ *  \param endEpoch Epoch at which the propagation is terminated
+ *  \param segmentDuration Duration of each propagated segment
+ *  \param stateOutputSinks Sinks receiving the propagated state
+ *  \param dependentVariableOutputSinks Sinks receiving the dependent variables (if any are defined in the propagator
+ *  settings)
+ *  \param outputFrequency Number of integration steps per output epoch (the output is decimated if larger than 1)
+ *  \return Final state of the propagation
+ */
+inline Eigen::VectorXd propagateWithStreamingOutput(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::function< std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > >(
+            const double ) > integratorSettingsFunction,
+        const std::function< std::shared_ptr< tudat::propagators::SingleArcPropagatorSettings< double > >(
+            const Eigen::VectorXd&, const double ) > propagatorSettingsFunction,
+        const Eigen::VectorXd& initialState,
+        const double startEpoch,
+        const double endEpoch,
+        const double segmentDuration,
+        const std::vector< std::shared_ptr< PropagationOutputSink > >& stateOutputSinks,
+        const std::vector< std::shared_ptr< PropagationOutputSink > >& dependentVariableOutputSinks =
+        std::vector< std::shared_ptr< PropagationOutputSink > >( ),
+        const int outputFrequency = 1 )
+{
+    if( !( segmentDuration > 0.0 ) || outputFrequency < 1 )
+    {
+        throw std::runtime_error( "Error in streaming propagation, segment duration and output frequency must be positive." );
+    }
+
+    Eigen::VectorXd currentState = initialState;
+    double currentEpoch = startEpoch;
+    long long numberOfSteps = 0;
+    bool isFirstSegment = true;
+    while( currentEpoch < endEpoch )
+    {
+        const double segmentEndEpoch = std::min( currentEpoch + segmentDuration, endEpoch );
+
+        // Propagate segment
+        tudat::propagators::SingleArcDynamicsSimulator< > dynamicsSimulator(
+                    bodyMap, integratorSettingsFunction( currentEpoch ),
+                    propagatorSettingsFunction( currentState, segmentEndEpoch ), true, false, false );
+        const std::map< double, Eigen::VectorXd >& segmentStateHistory =
+                dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+        const std::map< double, Eigen::VectorXd >& segmentDependentVariableHistory =
+                dynamicsSimulator.getDependentVariableHistory( );
+        if( segmentStateHistory.size( ) < 2 )
+        {
+            throw std::runtime_error( "Error in streaming propagation, no progress made in segment." );
+        }
+
+        // Pass output to sinks; the first entry of each segment (except the first one) is the last one of the previous one
+        for( auto stateIterator = segmentStateHistory.begin( ); stateIterator != segmentStateHistory.end( );
+             stateIterator++ )
+        {
+            if( stateIterator == segmentStateHistory.begin( ) )
+            {
+                if( !isFirstSegment )
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                numberOfSteps++;
+            }
+
+            if( numberOfSteps % outputFrequency == 0 )
+            {
+                for( unsigned int i = 0; i < stateOutputSinks.size( ); i++ )
+                {
+                    stateOutputSinks.at( i )->processOutput( stateIterator->first, stateIterator->second );
+                }
+
+                if( dependentVariableOutputSinks.size( ) > 0 )
+                {
+                    auto dependentVariableIterator = segmentDependentVariableHistory.find( stateIterator->first );
+                    if( dependentVariableIterator != segmentDependentVariableHistory.end( ) )
+                    {
+                        for( unsigned int i = 0; i < dependentVariableOutputSinks.size( ); i++ )
+                        {
+                            dependentVariableOutputSinks.at( i )->processOutput(
+                                        dependentVariableIterator->first, dependentVariableIterator->second );
+                        }
+                    }
+                }
+            }
+        }
+
+        currentEpoch = segmentStateHistory.rbegin( )->first;
+        currentState = segmentStateHistory.rbegin( )->second;
+        isFirstSegment = false;
+    }
+
+    for( unsigned int i = 0; i < stateOutputSinks.size( ); i++ )
+    {
+        stateOutputSinks.at( i )->finalizeOutput( );
+    }
+    for( unsigned int i = 0; i < dependentVariableOutputSinks.size( ); i++ )
+    {
+        dependentVariableOutputSinks.at( i )->finalizeOutput( );
+    }
+
+    return currentState;
+}
+
+} // namespace tudat_applications
+
+#endif // TUDAT_STREAMING_PROPAGATION_H